@@ -0,0 +1,310 @@
+/**
+ * @file Bench.c
+ * @author Bottini, Franco Nicolas
+ * @brief Benchmarks de MyShell. Mide la latencia y el ritmo de lanzamiento de cada backend, el reenvio de la salida de los trabajos,
+ * las pipelines, el reaping de trabajos en segundo plano y el despacho de comandos internos desde un batchfile.
+ * Cada resultado se emite por stdout como una linea JSON: {"name": ..., "value": ..., "unit": ..., "n": ...}.
+ *
+ * Uso: Bench <ruta de MyShell>. La variable BENCH_SCALE multiplica el numero de iteraciones (por defecto 1).
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../inc/JobControl.h"
+
+#include <sys/stat.h>
+
+/** Iteraciones base de cada benchmark, multiplicadas por BENCH_SCALE **/
+#define BENCH_LAUNCHES 2000
+#define BENCH_BACKGROUND_JOBS 10000
+#define BENCH_RELAY_BYTES (512L * 1024 * 1024)
+#define BENCH_PIPELINE_BYTES (1024L * 1024 * 1024)
+#define BENCH_SCRIPT_LINES 200000
+#define BENCH_EXTERN_LINES 2000
+
+/** Descriptor donde se emiten los resultados. La salida estandar se redirige a /dev/null durante las mediciones **/
+static FILE* results;
+
+static double scale = 1;
+
+static double now(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static long scaled(long n)
+{
+    long value = (long) (n * scale);
+
+    return value > 0 ? value : 1;
+}
+
+static void report(const char* name, double value, const char* unit, long n)
+{
+    fprintf(results, "{\"name\": \"%s\", \"value\": %.3f, \"unit\": \"%s\", \"n\": %ld}\n", name, value, unit, n);
+    fflush(results);
+}
+
+static int compare_double(const void* a, const void* b)
+{
+    double x = *(const double*) a, y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
+
+static double percentile(double* sorted, long n, double p)
+{
+    return sorted[(long) (p * (n - 1))];
+}
+
+static int run_job(const char* command, int mode)
+{
+    char* copy = strdup(command);
+    char* save;
+    job* j = new_job();
+
+    for (char* stage = strtok_r(copy, "|", &save); stage; stage = strtok_r(NULL, "|", &save))
+        new_process(j, stage);
+
+    free(copy);
+
+    update_job_mode(j);
+
+    if (mode == BACKGROUND_EXECUTION)
+        j->mode = BACKGROUND_EXECUTION;
+
+    return launch_job(j);
+}
+
+static void bench_launch(const char* backend)
+{
+    long n = scaled(BENCH_LAUNCHES);
+    double* samples = malloc(sizeof(double) * n);
+    char name[64];
+
+    set_launch_backend(backend);
+
+    double start = now();
+
+    for (long i = 0; i < n; i++)
+    {
+        double t = now();
+
+        run_job("true", FOREGROUND_EXECUTION);
+        samples[i] = (now() - t) * 1e6;
+    }
+
+    double total = now() - start;
+
+    qsort(samples, n, sizeof(double), compare_double);
+
+    snprintf(name, sizeof(name), "launch.%s.p50", backend);
+    report(name, percentile(samples, n, 0.50), "us", n);
+    snprintf(name, sizeof(name), "launch.%s.p99", backend);
+    report(name, percentile(samples, n, 0.99), "us", n);
+    snprintf(name, sizeof(name), "launch.%s.rate", backend);
+    report(name, n / total, "launches/s", n);
+
+    free(samples);
+}
+
+static void bench_relay(void)
+{
+    long bytes = scaled(BENCH_RELAY_BYTES);
+    char command[64];
+
+    snprintf(command, sizeof(command), "head -c %ld /dev/zero", bytes);
+
+    double start = now();
+
+    run_job(command, FOREGROUND_EXECUTION);
+
+    report("relay.throughput", bytes / (now() - start) / (1024 * 1024), "MiB/s", bytes);
+}
+
+static double time_command(char* const argv[], const char* script_cache)
+{
+    pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        int null_fd = open("/dev/null", O_RDWR);
+        sigset_t mask;
+
+        //El comando medido no hereda la mascara del shell, que mantiene SIGCHLD bloqueada.
+        sigemptyset(&mask);
+        sigprocmask(SIG_SETMASK, &mask, NULL);
+
+        if (script_cache)
+            setenv("MYSHELL_SCRIPT_CACHE", script_cache, 1);
+
+        dup2(null_fd, STDIN_FILENO);
+        dup2(null_fd, STDOUT_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+        execvp(argv[0], argv);
+        _exit(EXIT_COMMAND_NOT_FOUND);
+    }
+
+    int status;
+    double start = now();
+
+    //El hijo se espera directamente: SIGCHLD esta bloqueada y no pertenece a la tabla de trabajos.
+    waitpid(pid, &status, 0);
+
+    double elapsed = now() - start;
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_COMMAND_NOT_FOUND ? -1 : elapsed;
+}
+
+static void bench_pipeline(void)
+{
+    long bytes = scaled(BENCH_PIPELINE_BYTES);
+    char command[128];
+
+    snprintf(command, sizeof(command), "yes | head -c %ld | wc -c", bytes);
+
+    double start = now();
+
+    run_job(command, FOREGROUND_EXECUTION);
+
+    report("pipeline.myshell", bytes / (now() - start) / (1024 * 1024), "MiB/s", bytes);
+
+    //La misma pipeline en bash, como referencia.
+    char* argv[] = { "bash", "-c", command, NULL };
+    double elapsed = time_command(argv, NULL);
+
+    if (elapsed > 0)
+        report("pipeline.bash", bytes / elapsed / (1024 * 1024), "MiB/s", bytes);
+}
+
+static void bench_reap(void)
+{
+    long n = scaled(BENCH_BACKGROUND_JOBS);
+
+    set_launch_backend("spawn");
+
+    double start = now();
+
+    //Igual que el loop de un batchfile, se atienden los trabajos terminados entre un lanzamiento y el siguiente.
+    for (long i = 0; i < n; i++)
+    {
+        run_job("true", BACKGROUND_EXECUTION);
+        reap_children();
+    }
+
+    double launched = now();
+
+    wait_for_all_jobs(-1);
+
+    double end = now();
+
+    report("reap.background.launch", n / (launched - start), "jobs/s", n);
+    report("reap.background.drain", (end - launched) * 1e3, "ms", n);
+    report("reap.background.total", n / (end - start), "jobs/s", n);
+}
+
+static char* write_script(const char* dir, const char* name, const char* line, long lines)
+{
+    char* path;
+
+    if (asprintf(&path, "%s/%s", dir, name) < 0)
+        return NULL;
+
+    FILE* f = fopen(path, "w");
+
+    for (long i = 0; i < lines; i++)
+        fprintf(f, "%s\n", line);
+
+    fclose(f);
+
+    return path;
+}
+
+static void bench_script(const char* shell, const char* dir, const char* name, const char* line, long lines, const char* cache)
+{
+    char* path = write_script(dir, name, line, lines);
+    char* argv[] = { (char*) shell, path, NULL };
+    char metric[64];
+
+    //Con el archivo compilado habilitado, una primera ejecucion lo genera y se mide la siguiente.
+    if (cache == NULL)
+        time_command(argv, NULL);
+
+    double elapsed = time_command(argv, cache);
+
+    snprintf(metric, sizeof(metric), "script.%s", name);
+
+    if (elapsed > 0)
+        report(metric, lines / elapsed, "lines/s", lines);
+
+    free(path);
+}
+
+static void bench_dispatch(const char* shell)
+{
+    char dir[] = "/tmp/myshell-bench-XXXXXX";
+
+    if (mkdtemp(dir) == NULL)
+        return;
+
+    long lines = scaled(BENCH_SCRIPT_LINES);
+    long extern_lines = scaled(BENCH_EXTERN_LINES);
+
+    bench_script(shell, dir, "builtin.cached", "true", lines, NULL);
+    bench_script(shell, dir, "builtin.uncached", "true", lines, "0");
+    bench_script(shell, dir, "echo.cached", "echo bench", lines, NULL);
+    bench_script(shell, dir, "extern.cached", "/bin/true", extern_lines, NULL);
+
+    char* rm[] = { "rm", "-rf", dir, NULL };
+
+    time_command(rm, NULL);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <MyShell binary>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (getenv("BENCH_SCALE"))
+        scale = atof(getenv("BENCH_SCALE"));
+
+    //Los resultados salen por una copia de stdout; la salida que reenvia el shell se descarta.
+    results = fdopen(dup(STDOUT_FILENO), "w");
+
+    int null_fd = open("/dev/null", O_WRONLY);
+
+    dup2(null_fd, STDOUT_FILENO);
+    close(null_fd);
+
+    //Cada trabajo en segundo plano mantiene abiertos sus pipes hasta que se atiende su finalizacion.
+    struct rlimit files;
+
+    getrlimit(RLIMIT_NOFILE, &files);
+    files.rlim_cur = files.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &files);
+
+    job_control_init();
+
+    bench_launch("fork");
+    bench_launch("spawn");
+    bench_launch("zygote");
+    bench_relay();
+    bench_pipeline();
+    bench_reap();
+    bench_dispatch(argv[1]);
+
+    output_flush();
+    fclose(results);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file Arena.h
+ * @author Bottini, Franco Nicolas
+ * @brief Asignador de memoria por regiones. Todas las reservas de una region se liberan juntas en un unico paso.
+ * @version 1.2
+ * @date Septiembre de 2022
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+/** Tamaño de cada bloque de una region. El primero se reserva junto con la region **/
+#define ARENA_BLOCK_SIZE 1024
+
+/** Alineacion de las reservas realizadas sobre una region **/
+#define ARENA_ALIGNMENT sizeof(max_align_t)
+
+/** Bloque de memoria de una region **/
+typedef struct arena_block
+{
+    struct arena_block *next;   /** Bloque reservado anteriormente **/
+    size_t size;                /** Capacidad del bloque **/
+    size_t used;                /** Bytes utilizados del bloque **/
+    max_align_t data[];         /** Memoria del bloque **/
+} arena_block;
+
+/** Region de memoria **/
+typedef struct arena
+{
+    arena_block *blocks;    /** Bloque actual, enlazado con los anteriores **/
+} arena;
+
+/**
+ * @brief Crea una nueva region. La region y su primer bloque se obtienen con una unica reserva.
+ * 
+ * @return arena* Region creada.
+ */
+arena* arena_create(void);
+
+/**
+ * @brief Reserva memoria dentro de una region.
+ * 
+ * @param a Region sobre la cual reservar.
+ * @param size Numero de bytes a reservar.
+ * @return void* Puntero a la memoria reservada, alineada a ARENA_ALIGNMENT.
+ */
+void* arena_alloc(arena *a, size_t size);
+
+/**
+ * @brief Copia una cadena dentro de una region.
+ * 
+ * @param a Region sobre la cual reservar.
+ * @param str Cadena a copiar.
+ * @return char* Copia de la cadena.
+ */
+char* arena_strdup(arena *a, const char* str);
+
+/**
+ * @brief Libera una region y todas las reservas realizadas sobre ella.
+ * 
+ * @param a Region a liberar.
+ */
+void arena_destroy(arena *a);
+
+#endif //__ARENA_H__
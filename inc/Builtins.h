@@ -0,0 +1,72 @@
+/**
+ * @file Builtins.h
+ * @author Bottini, Franco Nicolas
+ * @brief Identificadores de los comandos internos y funcion de hash de sus nombres. Los comparten la shell y el generador
+ * de la tabla de hash perfecto (tools/BuiltinsGen.c), que busca una semilla sin colisiones para los nombres de Builtins.def.
+ * @version 1.2
+ * @date Septiembre de 2022
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef __BUILTINS_H__
+#define __BUILTINS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Flags de los comandos admitidos **/
+typedef enum COMMANDS_FLAGS
+{
+    CMM_EXTERN = -1,    /** Comando externo **/
+#define BUILTIN(id, name, handler, kind) id,
+#include "Builtins.def"
+#undef BUILTIN
+    CMM_BUILTINS_COUNT  /** Numero de comandos internos **/
+} COMMANDS_FLAGS;
+
+/** Tipos de comandos internos **/
+typedef enum BUILTIN_KINDS
+{
+    BUILTIN_PLAIN,      /** Comando propio del shell **/
+    BUILTIN_UTILITY,    /** Reemplaza a un programa externo del mismo nombre **/
+    BUILTIN_PREFIX      /** Ejecuta otro comando recibido como argumento **/
+} BUILTIN_KINDS;
+
+/** Funcion que ejecuta un comando interno a partir de sus argumentos **/
+typedef void (*builtin_handler)(char* args);
+
+/** Declaraciones de las funciones de los comandos internos, generadas a partir de la lista. Se definen en MyShell.c y Utilities.c **/
+#define BUILTIN(id, name, handler, kind) void handler(char* args);
+#include "Builtins.def"
+#undef BUILTIN
+
+/** Entrada de la tabla de comandos internos **/
+typedef struct builtin
+{
+    const char *name;           /** Nombre del comando **/
+    size_t len;                 /** Longitud del nombre **/
+    builtin_handler handler;    /** Funcion que lo ejecuta **/
+    BUILTIN_KINDS kind;         /** Tipo de comando interno **/
+} builtin;
+
+/**
+ * @brief Calcula el hash (FNV-1a con semilla) del nombre de un comando.
+ * 
+ * @param name Nombre del comando. No necesita estar terminado en '\0'.
+ * @param len Longitud del nombre.
+ * @param seed Semilla de la tabla generada.
+ * @return uint32_t Hash del nombre.
+ */
+static inline uint32_t builtin_hash(const char *name, size_t len, uint32_t seed)
+{
+    uint32_t hash = 2166136261u ^ seed;
+
+    for (size_t i = 0; i < len; i++)
+        hash = (hash ^ (unsigned char) name[i]) * 16777619u;
+
+    return hash ^ (hash >> 16);
+}
+
+#endif //__BUILTINS_H__
@@ -12,6 +12,10 @@
 #ifndef __JOB_CONTROL_H__
 #define __JOB_CONTROL_H__
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -20,6 +24,21 @@
 #include <sys/types.h>
 #include <fcntl.h>
 #include <string.h>
+#include <errno.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/signalfd.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "PathHash.h"
+#include "Arena.h"
+#include "Output.h"
+#include "Stats.h"
+#include "Zygote.h"
+#include "Policy.h"
+#include "RingBuffer.h"
 
 /** Define los codigos para cambiar el color del texto en la terminal **/
 #ifndef TERMINAL_TEXT_COLORS
@@ -34,12 +53,46 @@
     #define KWHT  "\x1B[37m"
 #endif
 
+/** Tamaño de los bloques utilizados al reenviar la salida de los trabajos **/
+#define RELAY_BUFFER_SIZE (64 * 1024)
+
+/** Capacidad del buffer donde se conserva la salida de cada trabajo en segundo plano **/
+#define JOB_OUTPUT_SIZE (64 * 1024)
+
+/** Capacidades iniciales de la tabla de trabajos y del indice de PIDs (potencias de 2) **/
+#define JOB_TABLE_INITIAL_SIZE 16
+#define PID_INDEX_INITIAL_SIZE 64
+
+/** Codigo de salida de un proceso que no pudo ejecutar su comando **/
+#define EXIT_COMMAND_NOT_FOUND 127
+
+/** Numero de descriptores estandar de un proceso (entrada, salida y salida de errores), los que admiten redirecciones **/
+#define STANDARD_STREAMS 3
+
+/** Permisos de los archivos creados por una redireccion, antes de aplicar la umask **/
+#define REDIRECT_FILE_MODE 0666
+
+/** Mecanismos disponibles para lanzar los procesos de un trabajo **/
+typedef enum LAUNCH_BACKENDS
+{
+    LAUNCH_FORK,    /** fork() seguido de execvp() **/
+    LAUNCH_SPAWN,   /** posix_spawnp(), sin copiar las tablas de paginas del shell **/
+    LAUNCH_ZYGOTE   /** Pedido a un proceso auxiliar creado al inicializar el control de trabajos **/
+} LAUNCH_BACKENDS;
+
+/** Mecanismo de lanzamiento por defecto. Puede redefinirse al compilar (-DLAUNCH_BACKEND_DEFAULT=LAUNCH_FORK) **/
+#ifndef LAUNCH_BACKEND_DEFAULT
+#define LAUNCH_BACKEND_DEFAULT LAUNCH_SPAWN
+#endif
+
 /** Filtros admitidos para la busqueda de procesos **/
 typedef enum PROCESS_FILTERS
 {
     PROC_FILTER_ALL,        /** Todos los procesos **/
     PROC_FILTER_DONE,       /** Procesos finalizados **/
-    PROC_FILTER_REMAINING   /** Procesos activos **/
+    PROC_FILTER_REMAINING,  /** Procesos activos **/
+    PROC_FILTER_RUNNING,    /** Procesos en ejecucion **/
+    PROC_FILTER_SUSPENDED   /** Procesos suspendidos **/
 } PROCESS_FILTERS;
 
 /** Tipos de ejecuciones admitidas por los trabajos **/
@@ -59,55 +112,147 @@ typedef enum PROCESS_STATUS
     STATUS_CONTINUED,   /** Reanudado **/
     STATUS_TERMINATED,  /** Anulado **/
     STATUS_NEW,         /** Nuevo proceso **/
-    STATUS_READY        /** Proceso agregado a un trabajo listo para correr **/
+    STATUS_READY,       /** Proceso agregado a un trabajo listo para correr **/
+    STATUS_QUEUED       /** Proceso de un trabajo en segundo plano que espera un lugar para lanzarse **/
 } PROCESS_STATUS;
 
 /** Estructura de datos que define un proceso **/
 typedef struct process 
 {
     struct process *next;   /** Siguiente proceso en la lista **/
-    u_int8_t argc;          /** Numero de argumentos para el proceso **/
+    struct job *job;        /** Trabajo al cual pertenece el proceso **/
+    int argc;               /** Numero de argumentos para el proceso **/
     char **argv;            /** Array de argumentos del proceso **/
+    const char *path;       /** Ruta del ejecutable obtenida de la tabla de rutas al lanzarlo. NULL si argv[0] contiene '/' **/
     pid_t pid;              /** Process ID **/
     PROCESS_STATUS status;  /** Estado del proceso **/
+    int wait_status;        /** Ultimo estado informado por waitpid **/
+    struct timespec started;    /** Instante (monotono) en que se lanzo **/
+    struct timespec finished;   /** Instante (monotono) en que termino **/
+    struct rusage usage;        /** Recursos consumidos, informados por wait4 al terminar **/
+    const char *redirect[STANDARD_STREAMS]; /** Archivo al que se redirige cada descriptor estandar. NULL si no se redirige **/
+    int redirect_flags[STANDARD_STREAMS];   /** Flags con los que se abre cada archivo redirigido **/
 } process;
 
 /** Estructura de datos que define un trabajo **/
 typedef struct job 
 {
-    struct job *next;               /** Siguiente trabajo en la lista **/
     int id;                         /** ID del trabajo **/
     struct process *first_process;  /** Primer proceso de la lista **/
+    arena *arena;                   /** Region donde se alojan el trabajo, sus procesos y sus argumentos **/
     pid_t pgid;                     /** Process group ID **/
     PROCESS_EXECUTION_MODES mode;   /** Modo de ejecucion **/
     int io_fd[2], err_fd[2];        /** Pipes de comunicacion **/
+    int timed;                      /** Indica si al terminar se informan los recursos consumidos (comando time) **/
+    int slot;                       /** Indica si ocupa un lugar del limite de trabajos en segundo plano **/
+    int queued;                     /** Indica si esta en la cola de trabajos en espera **/
+    struct job *next_queued;        /** Siguiente trabajo en la cola de espera **/
+    job_policy policy;              /** Politica de planificacion (CPUs, nice y clase de E/S) de sus procesos **/
+    ring_buffer output;             /** Ultima salida del trabajo en segundo plano. Se reserva en la region al recibir la primera **/
+    uint64_t output_shown;          /** Posicion de la salida hasta la cual ya se mostro **/
 } job;
 
+/** Recursos consumidos por un trabajo o un comando **/
+typedef struct job_usage
+{
+    double real;    /** Tiempo transcurrido (segundos) **/
+    double user;    /** Tiempo de CPU en modo usuario (segundos) **/
+    double sys;     /** Tiempo de CPU en modo sistema (segundos) **/
+    long maxrss;    /** Maximo conjunto residente (KB). En un trabajo, el mayor de sus procesos **/
+    long nvcsw;     /** Cambios de contexto voluntarios **/
+    long nivcsw;    /** Cambios de contexto involuntarios **/
+} job_usage;
+
 extern const char* PROCESS_STATUS_STRING[]; /** String-array de los estados de un proceso **/
 
-extern job *first_job; /** Primer trabajo de la lista **/
+extern job **job_table;     /** Tabla de trabajos indexada por ID. Las posiciones libres valen NULL **/
+extern int job_table_size;  /** Capacidad de la tabla de trabajos **/
+extern int job_table_max;   /** Mayor ID en uso. 0 si no hay trabajos **/
+extern int job_count;       /** Numero de trabajos en la tabla **/
+
+extern process **pid_index;     /** Indice hash (direccionamiento abierto) de procesos por PID **/
+extern size_t pid_index_size;   /** Capacidad del indice de PIDs **/
+extern size_t pid_index_count;  /** Procesos en el indice de PIDs **/
+
+extern LAUNCH_BACKENDS launch_backend; /** Mecanismo utilizado para lanzar los procesos **/
+
+extern int background_max;      /** Maximo de trabajos en segundo plano ejecutandose a la vez. 0 para no limitarlos **/
+extern int background_running;  /** Trabajos en segundo plano que ocupan un lugar del limite **/
+extern job *job_queue_head;     /** Primer trabajo de la cola de espera (FIFO). NULL si esta vacia **/
+extern job *job_queue_tail;     /** Ultimo trabajo de la cola de espera **/
+
+extern job_policy background_policy; /** Politica aplicada a los trabajos en segundo plano que no fijan la propia **/
+
+extern int sigchld_fd; /** signalfd por el cual se reciben las SIGCHLD **/
+
+extern int shell_terminal; /** Terminal controlada por el shell. -1 si el shell no controla ninguna terminal **/
+
+extern char **environ; /** Entorno del shell, heredado por los procesos lanzados **/
 
 /**
- * @brief Crea un nuevo trabajo.
+ * @brief Crea un nuevo trabajo vacio, en modo primer plano, dentro de su propia region de memoria.
  * 
- * @param first_process Primer proceso del nuevo trabajo.
- * @param mode Modo de ejecucion del nuevo trabajo.
  * @return job* Trabajo creado.
  */
-job* new_job(process *first_process);
+job* new_job(void);
 
 /**
- * @brief Crea un nuevo proceso.
+ * @brief Determina el modo de ejecucion de un trabajo a partir de su lista de procesos.
+ * Un '&' al final del ultimo proceso se elimina de sus argumentos y envia el trabajo a segundo plano.
  * 
+ * @param j Trabajo a actualizar.
+ */
+void update_job_mode(job *j);
+
+/**
+ * @brief Crea un nuevo proceso en la region de un trabajo y lo agrega a su lista de procesos.
+ * 
+ * @param j Trabajo al cual pertenece el proceso.
  * @param command Comando de ejecucion para el nuevo proceso.
  * @return process* Proceso creado.
  */
-process* new_process(char *command);
+process* new_process(job *j, char *command);
+
+/**
+ * @brief Crea un nuevo proceso a partir de argumentos ya separados y lo agrega a la lista de procesos de un trabajo.
+ * 
+ * @param j Trabajo al cual pertenece el proceso.
+ * @param args Argumentos consecutivos, cada uno terminado en '\0'. Se copian a la region del trabajo.
+ * @param argc Numero de argumentos.
+ * @return process* Proceso creado.
+ */
+process* new_process_argv(job *j, char *args, int argc);
+
+/**
+ * @brief Reconoce el operador de redireccion ("<", ">", ">>", "2>" o "2>>") al comienzo de un argumento.
+ * 
+ * @param arg Argumento a analizar. Si comienza con un operador, se avanza hasta el archivo que le sigue (vacio si esta separado).
+ * @param flags Donde se almacenan los flags con los que se abre el archivo.
+ * @return int Descriptor estandar que se redirige. -1 si el argumento no es una redireccion.
+ */
+int parse_redirection_operator(char **arg, int *flags);
+
+/**
+ * @brief Extrae las redirecciones ("<", ">", ">>", "2>" y "2>>", separadas o no del archivo) de los argumentos de un proceso.
+ * Los operadores y sus archivos se eliminan de los argumentos.
+ * 
+ * @param p Proceso a analizar.
+ * @return int 0 si las redirecciones son validas. -1 si a un operador le falta el archivo.
+ */
+int parse_redirections(process *p);
 
 /**
- * @brief Agrega un trabajo a la lista de trabajos.
+ * @brief Abre los archivos redirigidos de un proceso sobre sus descriptores estandar. Se utiliza en el hijo, antes de exec.
  * 
- * @param j Trabajo a agregar en la lista.
+ * @param p Proceso a ejecutar.
+ * @return int 0 si se abrieron todos los archivos. -1 si alguno fallo, informandolo por la salida de errores.
+ */
+int open_redirections(process *p);
+
+/**
+ * @brief Agrega un trabajo a la tabla de trabajos. Se le asigna el ID siguiente al del ultimo trabajo.
+ * 
+ * @param j Trabajo a agregar en la tabla.
  * @return int ID asignado al trabajo agregado.
  */
 int insert_job(job *j);
@@ -121,19 +266,33 @@ int insert_job(job *j);
 void insert_process(job *j, process *p);
 
 /**
- * @brief Elimina un trabajo de la lista y libera la memoria utilizada por el trabajo.
+ * @brief Elimina un trabajo de la tabla y del indice de PIDs y libera la memoria utilizada por el trabajo.
  * 
- * @param j Trabajo a eliminar del listado.
+ * @param j Trabajo a eliminar.
  */
 void remove_job(job *j);
 
 /**
- * @brief Obtiene el ultimo trabajo agregado a la lista.
+ * @brief Obtiene el trabajo con mayor ID de la tabla.
  * 
- * @return job* Ultimo trabajo del listado. NULL en caso de que la lista este vacia.
+ * @return job* Ultimo trabajo de la tabla. NULL en caso de que la tabla este vacia.
  */
 job* get_last_job();
 
+/**
+ * @brief Obtiene el numero de trabajos en la tabla.
+ * 
+ * @return int Numero de trabajos.
+ */
+int get_jobs_count(void);
+
+/**
+ * @brief Obtiene el numero de trabajos en la cola de espera.
+ * 
+ * @return int Numero de trabajos en espera.
+ */
+int get_queued_jobs_count(void);
+
 /**
  * @brief Obtiene el trabajo al cual pertenece un proceso a partir de su Process ID.
  * 
@@ -151,12 +310,18 @@ job* get_job_by_pid(int pid);
 job* get_job_by_id(int id);
 
 /**
- * @brief Obtiene el trabajo padre de un trabajo.
+ * @brief Agrega un proceso lanzado al indice de PIDs.
+ * 
+ * @param p Proceso a indexar. Su PID debe ser valido.
+ */
+void pid_index_insert(process *p);
+
+/**
+ * @brief Elimina un PID del indice de PIDs.
  * 
- * @param j Trabajo del cual se quiere obtener el padre.
- * @return job* Trabajo padre del trabajo dado.
+ * @param pid PID a eliminar.
  */
-job* get_job_parent(job *j);
+void pid_index_remove(pid_t pid);
 
 /**
  * @brief Obtiene el ID del trabajo al cual pertenece un proceso a partir de su Process ID.
@@ -216,36 +381,146 @@ int get_processes_count(job *j, int filter);
 void set_process_status(process *p, PROCESS_STATUS status);
 
 /**
- * @brief Inicializa el control de trabajos.
+ * @brief Inicializa el control de trabajos. Bloquea SIGCHLD y crea el signalfd por el cual se recolectan los hijos. El mecanismo de lanzamiento puede seleccionarse con la variable de entorno MYSHELL_LAUNCH.
+ * Si es el zygote, se crea en este momento.
  * 
  */
 void job_control_init(void);
 
 /**
- * @brief Se ejecuta al recibir una señal.
+ * @brief Recolecta todos los hijos que cambiaron de estado, actualiza sus procesos e informa los cambios de los trabajos en segundo plano.
+ * No se bloquea.
  * 
- * @param signal Señal recibida.
+ * @return int Numero de notificaciones de trabajos en segundo plano impresas.
  */
-void sigint_handler(int signal);
+int reap_children(void);
 
 /**
- * @brief Espera a la finalizacion de todos los procesos de un trabajo.
+ * @brief Espera, como maximo el tiempo dado, a que algun hijo cambie de estado y lo procesa.
  * 
- * @param j Trabajo al cual se debe esperar.
- * @return int Estado del trabajo al terminar.
+ * @param timeout Tiempo maximo de espera en milisegundos. -1 para esperar indefinidamente.
+ * @return int Numero de notificaciones de trabajos en segundo plano impresas.
  */
-int wait_for_job(job *j);
+int process_job_events(int timeout);
+
+/**
+ * @brief Se bloquea hasta que terminen todos los trabajos en ejecucion o venza el tiempo dado. Los trabajos suspendidos no se esperan.
+ * 
+ * @param timeout Tiempo maximo de espera en milisegundos. -1 para esperar indefinidamente.
+ * @return int Numero de trabajos que siguen en ejecucion.
+ */
+int wait_for_all_jobs(int timeout);
+
+/**
+ * @brief Obtiene el numero de trabajos con al menos un proceso en ejecucion, incluidos los que esperan en la cola para lanzarse.
+ * 
+ * @return int Numero de trabajos en ejecucion o en espera.
+ */
+int get_running_jobs_count(void);
+
+/**
+ * @brief Envia una señal al grupo de procesos de todos los trabajos de la tabla, seguida de SIGCONT para que los trabajos suspendidos la reciban.
+ * Los trabajos en espera se descartan.
+ * 
+ * @param signal Señal a enviar.
+ */
+void kill_all_jobs(int signal);
+
+/**
+ * @brief Espera a que haya datos para leer en un descriptor, atendiendo mientras tanto los cambios de estado de los trabajos.
+ * 
+ * @param fd Descriptor del cual se espera leer.
+ * @return int 0 si hay datos disponibles. Mayor a 0 si se imprimieron notificaciones de trabajos antes de que llegaran datos.
+ */
+int wait_for_input(int fd);
+
+/**
+ * @brief Espera eventos sobre un conjunto de descriptores con poll. Mientras tanto se recoge, en el buffer de cada trabajo,
+ * la salida de los trabajos en segundo plano, de modo que nunca se bloquean por un pipe lleno.
+ * 
+ * @param fds Descriptores del llamador. Al volver contienen sus eventos, como con poll.
+ * @param nfds Numero de descriptores del llamador.
+ * @param timeout Tiempo maximo de espera en milisegundos. -1 para esperar sin limite.
+ * @return int Resultado de poll, contando tambien los pipes de los trabajos en segundo plano.
+ */
+int poll_events(struct pollfd *fds, nfds_t nfds, int timeout);
+
+/**
+ * @brief Recoge en el buffer de salida de cada trabajo en segundo plano lo disponible en sus pipes, sin bloquearse.
+ * 
+ */
+void collect_background_output(void);
+
+/**
+ * @brief Recoge en el buffer de salida de un trabajo lo disponible en sus pipes, sin bloquearse. Cierra los pipes que alcanzaron EOF.
+ * 
+ * @param j Trabajo cuyos pipes se quieren vaciar.
+ * @return size_t Numero de bytes recogidos.
+ */
+size_t collect_job_output(job *j);
+
+/**
+ * @brief Imprime la salida conservada de un trabajo a partir de una posicion, indicando los bytes descartados si los hubo.
+ * 
+ * @param j Trabajo cuya salida se imprime.
+ * @param from Posicion desde la cual imprimir.
+ * @return size_t Numero de bytes impresos.
+ */
+size_t print_job_output(job *j, uint64_t from);
+
+/**
+ * @brief Imprime la salida de un trabajo en segundo plano a medida que se produce, hasta que el trabajo termina o se recibe SIGINT.
+ * 
+ * @param j Trabajo a seguir.
+ */
+void follow_job_output(job *j);
+
+/**
+ * @brief Actualiza el estado de un proceso a partir del estado informado por wait4. Si el proceso termino se guardan sus recursos consumidos.
+ * 
+ * @param p Proceso a actualizar.
+ * @param status Estado devuelto por wait4.
+ * @param usage Recursos devueltos por wait4.
+ */
+void update_process_status(process *p, int status, const struct rusage *usage);
 
 /**
- * @brief Espera por la finalizacion de un proceso.
+ * @brief Obtiene los recursos consumidos por un proceso. Si aun no termino solo se informa el tiempo transcurrido.
  * 
- * @param p Proceso a esperar.
- * @return int Estado del proceso al terminar.
+ * @param p Proceso a consultar.
+ * @param u Donde se almacenan los recursos.
  */
-int wait_for_process(process *p);
+void get_process_usage(process *p, job_usage *u);
+
+/**
+ * @brief Obtiene los recursos consumidos por un trabajo: tiempos de CPU y cambios de contexto sumados, y el mayor conjunto residente
+ * y tiempo transcurrido entre sus procesos.
+ * 
+ * @param j Trabajo a consultar.
+ * @param u Donde se almacenan los recursos.
+ */
+void get_job_usage(job *j, job_usage *u);
+
+/**
+ * @brief Calcula la diferencia en segundos entre dos instantes.
+ * 
+ * @param from Instante inicial.
+ * @param to Instante final.
+ * @return double Segundos transcurridos.
+ */
+double elapsed_seconds(const struct timespec *from, const struct timespec *to);
+
+/**
+ * @brief Espera a la finalizacion de todos los procesos de un trabajo, reenviando su salida a medida que se produce.
+ * 
+ * @param j Trabajo al cual se debe esperar.
+ * @return int Estado del ultimo proceso del trabajo al terminar. -1 si el trabajo quedo suspendido.
+ */
+int wait_for_job(job *j);
 
 /**
- * @brief Ejecuta todos los procesos de un trabajo.
+ * @brief Ejecuta todos los procesos de un trabajo. Un trabajo en segundo plano que excede el limite de trabajos
+ * concurrentes se agrega a la cola de espera y se lanza cuando se libera un lugar.
  * 
  * @param j Trabajo a ejecutar.
  * @return int Estadado del trbajo ejecutado.
@@ -253,13 +528,98 @@ int wait_for_process(process *p);
 int launch_job(job *j);
 
 /**
- * @brief Ejecuta un nuevo proceso.
+ * @brief Crea los pipes de un trabajo y lanza sus procesos, sin esperarlos.
+ * 
+ * @param j Trabajo a lanzar.
+ * @return int 0 si se lanzaron todos los procesos. -1 si alguno fallo.
+ */
+int start_job(job *j);
+
+/**
+ * @brief Agrega un trabajo al final de la cola de espera. Sus procesos quedan en estado STATUS_QUEUED.
+ * 
+ * @param j Trabajo a encolar. Debe estar en la tabla de trabajos.
+ */
+void enqueue_job(job *j);
+
+/**
+ * @brief Quita el primer trabajo de la cola de espera.
+ * 
+ * @return job* Trabajo quitado. NULL si la cola esta vacia.
+ */
+job* dequeue_job(void);
+
+/**
+ * @brief Lanza, en orden de llegada, los trabajos en espera que entran en el limite de trabajos en segundo plano.
+ * 
+ * @return int Numero de trabajos lanzados.
+ */
+int dispatch_queued_jobs(void);
+
+/**
+ * @brief Descarta un trabajo de la cola de espera y lo elimina de la tabla de trabajos.
+ * 
+ * @param j Trabajo a descartar. Si no esta en la cola no se hace nada.
+ */
+void cancel_queued_job(job *j);
+
+/**
+ * @brief Modifica el limite de trabajos en segundo plano ejecutandose a la vez y lanza los trabajos en espera que entren en el nuevo limite.
+ * 
+ * @param max Nuevo limite. 0 para no limitarlos.
+ */
+void set_background_max(int max);
+
+/**
+ * @brief Ejecuta un nuevo proceso sin esperar por su finalizacion. Las redirecciones del proceso reemplazan a los descriptores dados.
+ * 
+ * @param j Trabajo al cual pertenece el proceso.
+ * @param p Proceso a ejecutar.
+ * @param in_fd Descriptor a utilizar como entrada estandar del proceso.
+ * @param out_fd Descriptor a utilizar como salida estandar del proceso. -1 si la salida esta redirigida.
+ * @return int 0 si el proceso fue lanzado. -1 en caso de error.
+ */
+int launch_process(job *j, process *p, int in_fd, int out_fd);
+
+/**
+ * @brief Lanza un proceso mediante fork() y execvp().
+ * 
+ * @param j Trabajo al cual pertenece el proceso.
+ * @param p Proceso a ejecutar.
+ * @param in_fd Descriptor a utilizar como entrada estandar del proceso.
+ * @param out_fd Descriptor a utilizar como salida estandar del proceso.
+ * @return int 0 si el proceso fue lanzado. -1 en caso de error.
+ */
+int fork_process(job *j, process *p, int in_fd, int out_fd);
+
+/**
+ * @brief Lanza un proceso mediante posix_spawn(), que evita copiar el espacio de direcciones del shell.
  * 
  * @param j Trabajo al cual pertenece el proceso.
  * @param p Proceso a ejecutar.
- * @return int Estado del proceso ejecutado.
+ * @param in_fd Descriptor a utilizar como entrada estandar del proceso.
+ * @param out_fd Descriptor a utilizar como salida estandar del proceso.
+ * @return int 0 si el proceso fue lanzado. -1 en caso de error o si el comando no existe.
+ */
+int spawn_process(job *j, process *p, int in_fd, int out_fd);
+
+/**
+ * @brief Lanza un proceso a traves del zygote, que lo crea como hijo del shell. Si el zygote no esta disponible se utiliza posix_spawn().
+ * 
+ * @param j Trabajo al cual pertenece el proceso.
+ * @param p Proceso a ejecutar.
+ * @param in_fd Descriptor a utilizar como entrada estandar del proceso.
+ * @param out_fd Descriptor a utilizar como salida estandar del proceso.
+ * @return int 0 si el proceso fue lanzado. -1 en caso de error.
+ */
+int zygote_process(job *j, process *p, int in_fd, int out_fd);
+
+/**
+ * @brief Selecciona el mecanismo de lanzamiento de procesos a partir de su nombre ("fork", "spawn" o "zygote").
+ * 
+ * @param name Nombre del mecanismo. Los nombres desconocidos o NULL no modifican la seleccion actual.
  */
-int launch_process(job *j, process *p);
+void set_launch_backend(const char* name);
 
 /**
  * @brief Imprime por consola el estado de todos los trabajos del listado.
@@ -267,6 +627,20 @@ int launch_process(job *j, process *p);
  */
 void print_job_all_status();
 
+/**
+ * @brief Imprime por consola el estado de todos los trabajos del listado junto con los recursos consumidos por cada proceso (jobs -l).
+ * 
+ */
+void print_job_all_usage(void);
+
+/**
+ * @brief Imprime por consola los recursos consumidos por un trabajo o un comando, en el formato del comando time.
+ * 
+ * @param u Recursos a imprimir.
+ * @param id ID del trabajo, que se indica como encabezado. 0 para omitirlo.
+ */
+void print_usage(const job_usage *u, int id);
+
 /**
  * @brief Imprime por consola el estado de un trabajo dado.
  * 
@@ -282,34 +656,50 @@ void print_job_status(job *j);
 void print_job_process(job *j);
 
 /**
- * @brief Imprime por consola el contenido de la pipeline de un trabajo.
+ * @brief Reenvia a la terminal la salida disponible en los pipes de un trabajo sin bloquearse. Cierra los pipes que alcanzaron EOF.
+ * 
+ * @param j Trabajo cuyos pipes se quieren vaciar.
+ * @return size_t Numero de bytes reenviados.
+ */
+size_t drain_job_pipes(job *j);
+
+/**
+ * @brief Reenvia todo el contenido disponible en un descriptor hacia otro, leyendo por bloques.
+ * Si no se requiere color utiliza splice para evitar copias en espacio de usuario.
  * 
- * @param j Trabajo del cual queremos imprimir la pipeline.
+ * @param fd Descriptor desde el cual leer (extremo de lectura de un pipe).
+ * @param out_fd Descriptor hacia el cual escribir.
+ * @param color Codigo de color con el que envolver cada bloque. NULL para reenviar sin color.
+ * @param eof Puntero donde se indica si se alcanzo el fin del pipe.
+ * @return size_t Numero de bytes reenviados.
  */
-void print_job_pipe(job *j);
+size_t relay_pipe(int fd, int out_fd, const char* color, int* eof);
+
+/**
+ * @brief Escribe por completo un conjunto de buffers sobre un descriptor, reintentando escrituras parciales.
+ * 
+ * @param fd Descriptor sobre el cual escribir.
+ * @param iov Array de buffers a escribir. Se modifica durante la escritura.
+ * @param iovcnt Numero de elementos del array.
+ */
+void write_all_iov(int fd, struct iovec* iov, int iovcnt);
 
 /**
  * @brief Genera un array bidimensional segmentando una cadena en sus espacios. Se agrega NULL como ultimo elemento del array.
+ * El array y los argumentos se reservan en la region dada, la cadena original no se modifica.
  * 
+ * @param a Region donde reservar el array.
  * @param str Cadena a segmentar en formato de array.
  * @param n Puntero a donde se va a almacenar el numero de elementos del array.
  * @return char** Puntero al array bidimensional resultante.
  */
-char** str_to_array(char* str, u_int8_t* n);
+char** str_to_array(arena* a, char* str, int* n);
 
 /**
- * @brief Libera la memoria alocada por un trabajo.
+ * @brief Libera la memoria alocada por un trabajo, liberando su region en un unico paso.
  * 
  * @param j Trabajo a liberar.
  */
 void free_job(job *j);
 
-/**
- * @brief Libera la memoria alocada por un array bidimensional.
- * 
- * @param array Arrray a liberar.
- * @param n numero de lementos del array.
- */
-void free_array(char** array, u_int8_t n);
-
 #endif //__JOB_CONTROL_H__
\ No newline at end of file
@@ -0,0 +1,77 @@
+/**
+ * @file LineReader.h
+ * @author Bottini, Franco Nicolas
+ * @brief Lector de lineas sin limite de longitud sobre un descriptor de archivo.
+ * Los archivos regulares se mapean en memoria de solo lectura y cada linea se copia del mapeo a un buffer propio del lector,
+ * por lo que no se leen con read ni se duplican las paginas del archivo al escribir los fines de cadena.
+ * Para pipes y otros descriptores el buffer se reutiliza entre lecturas y solo crece cuando aparece una linea mas larga que las anteriores.
+ * @version 1.2
+ * @date Septiembre de 2022
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef __LINE_READER_H__
+#define __LINE_READER_H__
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+/** Capacidad inicial del buffer y tamaño minimo de cada lectura **/
+#define LINE_READER_CHUNK_SIZE (64 * 1024)
+
+/** Lector de lineas **/
+typedef struct line_reader
+{
+    int fd;             /** Descriptor desde el cual se lee **/
+    int interactive;    /** Indica si la entrada la escribe un usuario **/
+    char *buffer;       /** Buffer de lectura **/
+    size_t capacity;    /** Capacidad del buffer **/
+    size_t start;       /** Inicio de los datos aun no consumidos **/
+    size_t end;         /** Fin de los datos leidos **/
+    int eof;            /** Indica si se alcanzo el fin del descriptor **/
+    int mapped;         /** Indica si buffer es un mapeo del archivo en lugar de memoria dinamica **/
+    char *line;         /** Copia de la linea actual cuando se lee desde el mapeo **/
+    size_t line_capacity; /** Capacidad de la copia de la linea actual **/
+} line_reader;
+
+/**
+ * @brief Crea un lector de lineas sobre un descriptor. Si el descriptor es un archivo regular se mapea completo en memoria.
+ * 
+ * @param fd Descriptor desde el cual leer.
+ * @param interactive Indica si la entrada la escribe un usuario.
+ * @return line_reader* Lector creado.
+ */
+line_reader* line_reader_open(int fd, int interactive);
+
+/**
+ * @brief Lee la siguiente linea. El salto de linea se reemplaza por el fin de cadena.
+ * 
+ * @param r Lector del cual leer.
+ * @param line Puntero donde se almacena el comienzo de la linea. Es valido hasta la proxima lectura.
+ * @return ssize_t Longitud de la linea. -1 si no quedan lineas por leer.
+ */
+ssize_t line_reader_next(line_reader *r, char **line);
+
+/**
+ * @brief Indica si el lector ya tiene una linea completa en su buffer, es decir, si la proxima lectura no se bloquea.
+ * 
+ * @param r Lector a consultar.
+ * @return int 1 si hay una linea disponible. 0 en caso contrario.
+ */
+int line_reader_pending(line_reader *r);
+
+/**
+ * @brief Cierra el descriptor de un lector y libera su memoria.
+ * 
+ * @param r Lector a cerrar.
+ */
+void line_reader_close(line_reader *r);
+
+#endif //__LINE_READER_H__
@@ -13,12 +13,21 @@
 #ifndef __MYSHELL_H__
 #define __MYSHELL_H__
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <limits.h>
 
 #include "JobControl.h"
+#include "LineReader.h"
+#include "ScriptCache.h"
+#include "Builtins.h"
+#include "Utilities.h"
 
 /** Define los codigos para cambiar el color del texto en la terminal **/
 #ifndef TERMINAL_TEXT_COLORS
@@ -41,56 +50,95 @@
     #define ASCII_MIDDLE_DASH '-'
     #define ASCII_SPACE ' '
     #define ASCII_LINE_BREAK '\n'
+    #define ASCII_PIPE '|'
 #endif
 
-/** Longitud maxima de las entradas que admtide el programa **/
-#define MAX_LEN_INPUT 256 
-
 /** Macro para calcular el tamaño de un const array **/
 #define CONST_STR_ARR_SIZE(arr) sizeof(arr) / sizeof(*arr)
 
 /** Posibles resultados al leer las entradas de comandos **/
 typedef enum READ_INPUT_RESULT
 {
-    INP_TO_LONG = -2,   /** La entrada supera la longitud maxima admitida **/
     INP_END = -1,       /** No hay entradas que leer **/
     INP_EMPTY_LINE = 0, /** Lectura de una linea vacia **/
     INP_READ = 1        /** Lectura exitosa de una entrada **/
 } READ_INPUT_RESULT;
 
-/** Flags de los comandos admitidos **/
-typedef enum COMMANDS_FLAGS
+/** Estado de un batchfile ejecutado de forma concurrente con otros (opcion -j) **/
+typedef struct script_worker
 {
-    CMM_EXTERN = -1,    /** Comando externo **/
-    CMM_QUIT = 0,       /** Comando quit **/
-    CMM_CD = 1,         /** Comando cd **/
-    CMM_CLR = 2,        /** Comando clear **/
-    CMM_ECHO = 3,       /** Comando echo **/
-    CMM_JOBS = 4        /** Comando jobs **/
-} COMMANDS_FLAGS;
-
-/** Array de los comandos admitidos **/
-const char* CMM_VALIDS[] = {
-    "quit",
-    "cd",
-    "clr",
-    "echo",
-    "jobs"
-};
-
-/**
- * @brief Valida que el numero de parametros introducido al ejecutar el programa sea valido.
+    char *name;         /** Ruta del batchfile **/
+    pid_t pid;          /** PID de la copia del shell que lo ejecuta. -1 si no inicio o ya termino **/
+    int out_fd;         /** Extremo de lectura de su salida. -1 si no inicio o ya se cerro **/
+    char *pending;      /** Salida recibida que aun no forma una linea completa **/
+    size_t pending_len; /** Longitud de la salida pendiente **/
+} script_worker;
+
+/** Codigo de salida del ultimo comando ejecutado ($?) **/
+extern int last_exit_status;
+
+/** Tiempo maximo (segundos) de espera por los trabajos al finalizar un batchfile. -1 para esperar indefinidamente **/
+extern int batch_wait_timeout;
+
+/** Indica si al vencer el tiempo de espera se deben terminar los trabajos restantes **/
+extern int batch_kill_on_timeout;
+
+/** Numero maximo de batchfiles ejecutados de forma concurrente. 0 si no se indico la opcion -j **/
+extern int batch_max_workers;
+
+/** Indica si al finalizar cada batchfile se imprimen los histogramas de latencia (opcion -s) **/
+extern int batch_dump_stats;
+
+/**
+ * @brief Procesa las opciones de la linea de comandos y valida que el numero de parametros introducido al ejecutar el programa sea valido.
  * 
  * @param argc Numero de argumentos de entrada.
+ * @param argv Array de argumentos de entrada.
+ */
+void myshell_validate_execution(int argc, char* argv[]);
+
+/**
+ * @brief Imprime por consola la forma de uso del programa.
+ * 
+ */
+void myshell_print_usage(void);
+
+/**
+ * @brief Espera a los trabajos en segundo plano al alcanzar el final del batchfile, respetando el tiempo maximo configurado.
+ * 
  */
-void myshell_validate_execution(int argc);
+void myshell_wait_jobs(void);
 
 /**
  * @brief Ejecuta el loop principal de la shell de manera indefinida.
  * 
- * @param input_source Archivo desde el cual se van a tomar las entradas de comandos.
+ * @param input_source Lector desde el cual se van a tomar las entradas de comandos.
+ */
+void myshell_loop(line_reader* input_source);
+
+/**
+ * @brief Ejecuta un batchfile desde su forma compilada y finaliza el programa al terminar, luego de esperar a sus trabajos en segundo plano.
+ * Si no es un archivo regular (un FIFO, /dev/stdin o una sustitucion de procesos) se ejecuta linea a linea, sin compilarlo.
+ * 
+ * @param path Ruta del batchfile.
+ */
+void myshell_run_batch(const char* path);
+
+/**
+ * @brief Obtiene la forma compilada de un batchfile. Si no hay un archivo compilado valido, analiza cada linea del batchfile
+ * y guarda el resultado junto a el para las proximas ejecuciones. Finaliza el programa si no se puede abrir el batchfile.
+ * 
+ * @param path Ruta del batchfile.
+ * @return script_cache* Batchfile compilado.
  */
-void myshell_loop(FILE* input_source);
+script_cache* compile_batch_file(const char* path);
+
+/**
+ * @brief Calcula una firma de la tabla de comandos internos. Un batchfile compilado con otra tabla se vuelve a compilar.
+ * 
+ * @return uint64_t Firma de la tabla.
+ */
+uint64_t builtins_signature(void);
 
 /**
  * @brief Imprime por consola el prompt.
@@ -103,9 +151,45 @@ void print_prompt(void);
  * 
  * @param argc Numero de argumentos de entrada.
  * @param argv Array de argumentos de entrada.
- * @return FILE* Puntero al archivo desde el cual se van a tomar los comandos entrantes.
+ * @return line_reader* Lector desde el cual se van a tomar los comandos entrantes.
  */
-FILE* command_source(int argc, char* argv[]);
+line_reader* command_source(int argc, char* argv[]);
+
+/**
+ * @brief Abre un batchfile para leer sus comandos. Finaliza el programa si no se puede abrir.
+ * 
+ * @param path Ruta del batchfile.
+ * @return line_reader* Lector del batchfile.
+ */
+line_reader* open_batch_file(const char* path);
+
+/**
+ * @brief Ejecuta varios batchfiles, hasta max_workers a la vez, cada uno en una copia del shell con su propio directorio,
+ * entorno y tabla de trabajos. Cada linea de salida se precede con el nombre de su batchfile.
+ * 
+ * @param count Numero de batchfiles.
+ * @param scripts Rutas de los batchfiles.
+ * @param max_workers Numero maximo de batchfiles en ejecucion simultanea.
+ * @return int EXIT_SUCCESS si todos los batchfiles terminaron correctamente. EXIT_FAILURE en caso contrario.
+ */
+int myshell_run_scripts(int count, char* scripts[], int max_workers);
+
+/**
+ * @brief Lanza la copia del shell que ejecuta un batchfile, con su salida redirigida a un pipe.
+ * 
+ * @param workers Array con todos los batchfiles.
+ * @param count Numero de elementos del array.
+ * @param i Posicion del batchfile a lanzar.
+ * @return int 0 si se lanzo. -1 en caso de error.
+ */
+int start_script_worker(script_worker* workers, int count, int i);
+
+/**
+ * @brief Lee la salida disponible de un batchfile y la imprime linea por linea precedida por su nombre.
+ * 
+ * @param w Batchfile del cual reenviar la salida.
+ */
+void relay_script_output(script_worker* w);
 
 /**
  * @brief Interpreta y ejecuta un comando dado.
@@ -114,6 +198,24 @@ FILE* command_source(int argc, char* argv[]);
  */
 void execute_input(char* input);
 
+/**
+ * @brief Busca un comando interno por su nombre en la tabla de hash perfecto generada al compilar.
+ * 
+ * @param name Nombre del comando. No necesita estar terminado en '\0'.
+ * @param len Longitud del nombre.
+ * @return COMMANDS_FLAGS Identificador del comando interno. CMM_EXTERN si no es un comando interno.
+ */
+COMMANDS_FLAGS find_builtin(const char* name, size_t len);
+
+/**
+ * @brief Identifica el comando de una entrada. La entrada no se modifica.
+ * 
+ * @param input Entrada a identificar.
+ * @param args Donde se almacena el comienzo de los argumentos del comando, sin los espacios iniciales.
+ * @return COMMANDS_FLAGS Identificador del comando interno, o CMM_EXTERN si es un comando externo o una pipeline.
+ */
+COMMANDS_FLAGS classify_input(char* input, char** args);
+
 /**
  * @brief Ejecuta un comando a partir de su identificador y sus argumentos. 
  * 
@@ -123,14 +225,37 @@ void execute_input(char* input);
 void command_interprete(COMMANDS_FLAGS cmm, char* args);
 
 /**
- * @brief Get the Input object
+ * @brief Ejecuta un comando interno en el propio shell, con sus redirecciones aplicadas mientras dura.
+ * 
+ * @param cmm Identificador del comando interno.
+ * @param args Argumentos del comando, que pueden incluir redirecciones.
+ */
+void execute_builtin(COMMANDS_FLAGS cmm, char* args);
+
+/**
+ * @brief Aplica las redirecciones de un comando interno sobre los descriptores estandar del shell y las elimina de sus argumentos.
+ * 
+ * @param args Argumentos del comando.
+ * @param saved Donde se almacenan copias de los descriptores redirigidos, para restaurarlos. -1 en los que no se redirigen.
+ * @return int 0 si se aplicaron todas. -1 si alguna fallo, informandolo; en ese caso los descriptores ya quedan restaurados.
+ */
+int redirect_builtin(char* args, int saved[STANDARD_STREAMS]);
+
+/**
+ * @brief Restaura los descriptores estandar del shell luego de ejecutar un comando interno redirigido.
  * 
- * @param buffer Puntero al buffer donde se quiere almacenar la lectura.
- * @param buffer_size Tamaño del buffer donde se quiere almacenar la lectura.
- * @param fp Puntero al archivo desde donde se debe realizar la lectura.
+ * @param saved Copias de los descriptores, obtenidas con redirect_builtin.
+ */
+void restore_builtin_streams(int saved[STANDARD_STREAMS]);
+
+/**
+ * @brief Lee la siguiente entrada de comandos, sin limite de longitud, y elimina sus espacios en blanco al comienzo y final.
+ * 
+ * @param reader Lector desde donde se debe realizar la lectura.
+ * @param line Puntero donde se almacena la entrada leida. Es valida hasta la proxima lectura.
  * @return READ_INPUT_RESULT Codigo que indica el resultado de la operacion.
  */
-READ_INPUT_RESULT get_input(char* buffer, int buffer_size, FILE* fp);
+READ_INPUT_RESULT get_input(line_reader* reader, char** line);
 
 /**
  * @brief Elimina los espacios en blanco al comienzo y final de una cadena.
@@ -141,36 +266,41 @@ READ_INPUT_RESULT get_input(char* buffer, int buffer_size, FILE* fp);
 char* trim_white_space(char* str);
 
 /**
- * @brief Cambia de directorio de trabajo.
+ * @brief Ejectura un comando externo al programa en un nuevo proceso. Si el comando es una pipeline ('|') se lanza un proceso por etapa.
  * 
- * @param dir directorio al que se quiere ir.
+ * @param command path del comando a ejecutar.
  */
-void execute_cd(char* dir);
+void execute_extern(char* command);
 
 /**
- * @brief Envia un mensaje o el valor de una variable de entorno a la terminal.
+ * @brief Obtiene el codigo de salida de un comando externo a partir del resultado de lanzar su trabajo.
  * 
- * @param value mensaje o variable de entorno a enviar.
+ * @param status Estado devuelto por launch_job. Negativo si el trabajo no se pudo lanzar o quedo detenido.
+ * @return int Codigo de salida del ultimo proceso, o 128 mas la señal que lo termino.
  */
-void execute_echo(char* value);
+int job_exit_status(int status);
 
 /**
- * @brief Ejectura un comando externo al programa en un nuevo proceso.
+ * @brief Crea el trabajo de un comando externo, con un proceso por cada etapa de la pipeline. Informa si la pipeline es invalida.
  * 
- * @param command path del comando a ejecutar.
+ * @param command Comando a separar en etapas y argumentos.
+ * @return job* Trabajo listo para lanzar. NULL si no hay nada que ejecutar.
  */
-void execute_extern(char* command);
+job* build_job(char* command);
 
 /**
- * @brief Finaliza la ejecucion del programa.
+ * @brief Ejecuta un comando externo de un batchfile compilado, con sus etapas y argumentos ya separados.
  * 
+ * @param line Linea compilada.
  */
-void execute_quit(void);
+void execute_compiled_extern(script_line* line);
 
 /**
- * @brief Limpia la terminal.
+ * @brief Verifica que un comando interno no haya recibido parametros, informando el error en caso contrario.
  * 
+ * @param args Argumentos del comando.
+ * @return int 1 si no hay parametros. 0 en caso contrario.
  */
-void execute_clr(void);
+int check_no_arguments(char* args);
 
 #endif //__MYSHELL_H__
\ No newline at end of file
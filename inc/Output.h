@@ -0,0 +1,91 @@
+/**
+ * @file Output.h
+ * @author Bottini, Franco Nicolas
+ * @brief Buffer de salida compartido por todo el shell. Los comandos internos, el prompt y los avisos de trabajos se arman
+ * en memoria y se emiten con una unica escritura al vaciarlo, en lugar de una escritura por cada fragmento.
+ * Se debe vaciar antes de crear procesos o de escribir directamente sobre la salida estandar para conservar el orden.
+ * @version 1.2
+ * @date Septiembre de 2022
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef __OUTPUT_H__
+#define __OUTPUT_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+/** Capacidad inicial del buffer de salida **/
+#define OUTPUT_INITIAL_SIZE 4096
+
+/** Salida acumulada a partir de la cual output_sync la emite cuando la salida se almacena por bloques **/
+#define OUTPUT_BLOCK_SIZE (64 * 1024)
+
+/** Buffer de salida **/
+typedef struct output_buffer
+{
+    char *data;         /** Salida pendiente **/
+    size_t len;         /** Bytes pendientes **/
+    size_t capacity;    /** Capacidad del buffer **/
+    size_t block;       /** Salida acumulada a partir de la cual output_sync la emite. 0 para emitirla siempre **/
+} output_buffer;
+
+/** Buffer de salida del shell **/
+extern output_buffer shell_output;
+
+/**
+ * @brief Agrega datos al buffer de salida.
+ * 
+ * @param data Datos a agregar.
+ * @param len Longitud de los datos.
+ */
+void output_append(const char *data, size_t len);
+
+/**
+ * @brief Agrega una cadena al buffer de salida.
+ * 
+ * @param str Cadena a agregar.
+ */
+void output_puts(const char *str);
+
+/**
+ * @brief Agrega texto con formato al buffer de salida.
+ * 
+ * @param format Formato, como en printf.
+ */
+void output_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief Informa un error por la salida de errores, luego de emitir la salida pendiente para que aparezca en orden.
+ * 
+ * @param format Formato, como en printf.
+ */
+void output_error(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief Emite la salida pendiente sobre la salida estandar con una unica escritura, precedida por lo que haya quedado en stdio.
+ * 
+ */
+void output_flush(void);
+
+/**
+ * @brief Marca el fin de la salida de un comando. Se emite de inmediato, salvo que la salida se almacene por bloques y aun no se
+ * haya acumulado un bloque completo.
+ * 
+ */
+void output_sync(void);
+
+/**
+ * @brief Indica si la salida se almacena por bloques, como hace stdio cuando la salida estandar no es una terminal.
+ * 
+ * @param enabled 1 para almacenarla por bloques. 0 para emitirla al final de cada comando.
+ */
+void output_set_block_buffered(int enabled);
+
+#endif //__OUTPUT_H__
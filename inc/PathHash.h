@@ -0,0 +1,78 @@
+/**
+ * @file PathHash.h
+ * @author Bottini, Franco Nicolas
+ * @brief Tabla hash con las rutas absolutas de los comandos externos, al estilo del builtin hash de bash.
+ * @version 1.2
+ * @date Septiembre de 2022
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef __PATH_HASH_H__
+#define __PATH_HASH_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "Output.h"
+
+/** Capacidad inicial de la tabla (potencia de 2) **/
+#define PATH_HASH_INITIAL_SIZE 64
+
+/** Entrada de la tabla hash de rutas **/
+typedef struct path_hash_entry
+{
+    char *name;         /** Nombre del comando **/
+    char *path;         /** Ruta absoluta resuelta a partir de PATH **/
+    unsigned int hits;  /** Numero de veces que se utilizo la entrada **/
+} path_hash_entry;
+
+/**
+ * @brief Obtiene la ruta de un comando, resolviendola a partir de PATH y guardandola en la tabla si no estaba.
+ * La tabla se vacia automaticamente cuando cambia el valor de PATH.
+ * 
+ * @param name Nombre del comando (sin '/').
+ * @return const char* Ruta del ejecutable. NULL si el comando no se encuentra en PATH.
+ */
+const char* path_hash_lookup(const char* name);
+
+/**
+ * @brief Resuelve un comando y lo agrega a la tabla sin contabilizar su uso.
+ * 
+ * @param name Nombre del comando.
+ * @return int 0 si el comando fue agregado. -1 si no se encuentra en PATH.
+ */
+int path_hash_insert(const char* name);
+
+/**
+ * @brief Elimina un comando de la tabla. Se utiliza cuando la ruta guardada deja de ser valida.
+ * 
+ * @param name Nombre del comando.
+ */
+void path_hash_remove(const char* name);
+
+/**
+ * @brief Elimina todas las entradas de la tabla.
+ * 
+ */
+void path_hash_clear(void);
+
+/**
+ * @brief Imprime por consola las entradas de la tabla junto al numero de usos.
+ * 
+ */
+void print_path_hash(void);
+
+/**
+ * @brief Busca un comando en los directorios de PATH.
+ * 
+ * @param name Nombre del comando.
+ * @return char* Ruta del ejecutable alocada dinamicamente. NULL si no se encuentra.
+ */
+char* resolve_command_path(const char* name);
+
+#endif //__PATH_HASH_H__
@@ -0,0 +1,128 @@
+/**
+ * @file Policy.h
+ * @author Bottini, Franco Nicolas
+ * @brief Politica de planificacion de los procesos de un trabajo: conjunto de CPUs (sched_setaffinity), valor nice
+ * y clase de prioridad de E/S (ioprio_set). Se aplica en cada proceso antes de exec, o desde el shell cuando el mecanismo
+ * de lanzamiento no permite ejecutar codigo en el hijo.
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __POLICY_H__
+#define __POLICY_H__
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+/** Constantes de ioprio_set, que glibc no expone **/
+#define IOPRIO_WHO_PROCESS 1
+#define IOPRIO_CLASS_SHIFT 13
+#define IOPRIO_LEVELS 8
+#define IOPRIO_DEFAULT_LEVEL 4
+
+/** Tamaño del buffer donde se describe una politica **/
+#define POLICY_STRING_SIZE 256
+
+/** Clases de prioridad de E/S **/
+typedef enum IOPRIO_CLASSES
+{
+    IOPRIO_CLASS_NONE,  /** Sin modificar **/
+    IOPRIO_CLASS_RT,    /** Tiempo real **/
+    IOPRIO_CLASS_BE,    /** Best-effort **/
+    IOPRIO_CLASS_IDLE   /** Solo cuando el disco esta libre **/
+} IOPRIO_CLASSES;
+
+/** Politica de planificacion de un trabajo **/
+typedef struct job_policy
+{
+    cpu_set_t cpus;     /** CPUs en las que pueden correr los procesos **/
+    int has_cpus;       /** Indica si se fijo el conjunto de CPUs **/
+    int automatic;      /** Indica si la CPU se asigno de forma automatica (round-robin) **/
+    int nice;           /** Valor nice de los procesos **/
+    int has_nice;       /** Indica si se fijo el valor nice **/
+    int io_class;       /** Clase de prioridad de E/S. IOPRIO_CLASS_NONE para no modificarla **/
+    int io_level;       /** Nivel dentro de la clase de E/S (0 el mas prioritario) **/
+} job_policy;
+
+extern const char* IOPRIO_CLASS_STRING[]; /** String-array de los nombres de las clases de E/S **/
+
+/**
+ * @brief Inicializa una politica vacia, que no modifica nada.
+ *
+ * @param policy Politica a inicializar.
+ */
+void policy_clear(job_policy *policy);
+
+/**
+ * @brief Indica si una politica modifica algun atributo de los procesos.
+ *
+ * @param policy Politica a consultar.
+ * @return int 1 si modifica algun atributo. 0 en caso contrario.
+ */
+int policy_is_set(const job_policy *policy);
+
+/**
+ * @brief Registra las CPUs disponibles para el shell, entre las que se reparten los trabajos de forma automatica.
+ *
+ */
+void policy_setup(void);
+
+/**
+ * @brief Asigna a una politica la siguiente CPU disponible, en orden round-robin.
+ *
+ * @param policy Politica a completar.
+ * @return int 0 si se asigno una CPU. -1 si hay una sola CPU disponible y no tiene sentido repartir.
+ */
+int policy_assign_cpu(job_policy *policy);
+
+/**
+ * @brief Aplica una politica a un proceso. Los errores se informan por la salida de errores y no impiden aplicar el resto.
+ *
+ * @param policy Politica a aplicar.
+ * @param pid Proceso destino. 0 para el proceso actual.
+ * @return int 0 si se aplicaron todos los atributos. -1 si alguno fallo.
+ */
+int apply_policy(const job_policy *policy, pid_t pid);
+
+/**
+ * @brief Interpreta una lista de CPUs ("0-3,6").
+ *
+ * @param list Lista a interpretar.
+ * @param set Donde se almacena el conjunto de CPUs.
+ * @return int 0 si la lista es valida. -1 en caso contrario.
+ */
+int parse_cpu_list(const char *list, cpu_set_t *set);
+
+/**
+ * @brief Interpreta una clase de E/S con nivel opcional ("idle", "be:7", "rt:0" o su numero, "2:7").
+ *
+ * @param spec Clase a interpretar.
+ * @param policy Politica donde se almacenan la clase y el nivel.
+ * @return int 0 si la clase es valida. -1 en caso contrario.
+ */
+int parse_io_class(const char *spec, job_policy *policy);
+
+/**
+ * @brief Describe una politica en una linea ("cpu 0-3 nice 10 io idle").
+ *
+ * @param policy Politica a describir.
+ * @param buffer Donde se escribe la descripcion.
+ * @param size Tamaño del buffer.
+ */
+void format_policy(const job_policy *policy, char *buffer, size_t size);
+
+#endif //__POLICY_H__
@@ -0,0 +1,83 @@
+/**
+ * @file RingBuffer.h
+ * @author Bottini, Franco Nicolas
+ * @brief Buffer circular de capacidad fija. Conserva los ultimos bytes escritos: al llenarse, cada escritura descarta los mas antiguos.
+ * Las posiciones se expresan como el numero de bytes escritos desde el comienzo, por lo que un lector puede recordar hasta donde leyo
+ * y detectar cuantos bytes se descartaron desde entonces.
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __RING_BUFFER_H__
+#define __RING_BUFFER_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/uio.h>
+
+/** Buffer circular **/
+typedef struct ring_buffer
+{
+    char *data;         /** Memoria del buffer. NULL si todavia no se asigno **/
+    size_t size;        /** Capacidad **/
+    uint64_t written;   /** Bytes escritos desde el comienzo. El proximo se escribe en written % size **/
+} ring_buffer;
+
+/**
+ * @brief Inicializa un buffer vacio sobre una memoria provista por el llamador.
+ *
+ * @param r Buffer a inicializar.
+ * @param data Memoria del buffer. NULL para asignarla mas adelante.
+ * @param size Capacidad de la memoria.
+ */
+void ring_init(ring_buffer *r, char *data, size_t size);
+
+/**
+ * @brief Escribe en el buffer, descartando los bytes mas antiguos si no hay lugar.
+ *
+ * @param r Buffer donde escribir.
+ * @param data Datos a escribir.
+ * @param n Numero de bytes.
+ */
+void ring_write(ring_buffer *r, const char *data, size_t n);
+
+/**
+ * @brief Obtiene la posicion del byte mas antiguo que conserva el buffer.
+ *
+ * @param r Buffer a consultar.
+ * @return uint64_t Posicion del byte mas antiguo.
+ */
+uint64_t ring_first(const ring_buffer *r);
+
+/**
+ * @brief Obtiene los bytes conservados desde una posicion hasta el final, sin copiarlos.
+ *
+ * @param r Buffer a consultar.
+ * @param from Posicion desde la cual leer. Si ya se descarto, se lee desde el byte mas antiguo.
+ * @param iov Donde se almacenan los (hasta dos) tramos contiguos a leer.
+ * @return int Numero de tramos.
+ */
+int ring_segments(const ring_buffer *r, uint64_t from, struct iovec iov[2]);
+
+/**
+ * @brief Obtiene la posicion donde comienza la primera linea completa conservada a partir de una posicion.
+ *
+ * @param r Buffer a consultar.
+ * @param from Posicion desde la cual buscar. Si ya se descarto, se busca desde el byte mas antiguo.
+ * @return uint64_t Posicion del comienzo de la linea. Si no hay ninguna completa, la posicion del byte mas antiguo.
+ */
+uint64_t ring_next_line(const ring_buffer *r, uint64_t from);
+
+/**
+ * @brief Obtiene la posicion donde comienzan las ultimas lineas conservadas.
+ *
+ * @param r Buffer a consultar.
+ * @param lines Numero de lineas.
+ * @return uint64_t Posicion del comienzo de la primera de ellas.
+ */
+uint64_t ring_tail_lines(const ring_buffer *r, int lines);
+
+#endif //__RING_BUFFER_H__
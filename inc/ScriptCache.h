@@ -0,0 +1,159 @@
+/**
+ * @file ScriptCache.h
+ * @author Bottini, Franco Nicolas
+ * @brief Forma compilada de un batchfile. Cada linea se analiza una sola vez y se guarda ya separada en comando interno
+ * y argumentos, o en las etapas y argumentos de un comando externo. El resultado se almacena en un archivo junto al batchfile
+ * (".<nombre>.msc") y se reutiliza mientras el batchfile no cambie.
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __SCRIPT_CACHE_H__
+#define __SCRIPT_CACHE_H__
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+/** Identificador del formato del archivo compilado **/
+#define SCRIPT_CACHE_MAGIC 0x3143534D /* "MSC1" */
+
+/** Version del formato del archivo compilado **/
+#define SCRIPT_CACHE_VERSION 2
+
+/** Extension del archivo compilado **/
+#define SCRIPT_CACHE_SUFFIX ".msc"
+
+/** Variable de entorno que deshabilita el archivo compilado con el valor "0" **/
+#define SCRIPT_CACHE_ENV "MYSHELL_SCRIPT_CACHE"
+
+/** Cabecera del archivo compilado. Identifica la version del batchfile a partir de la cual se genero **/
+typedef struct script_cache_header
+{
+    uint32_t magic;         /** SCRIPT_CACHE_MAGIC **/
+    uint32_t version;       /** SCRIPT_CACHE_VERSION **/
+    uint64_t signature;     /** Firma de la tabla de comandos internos con la que se compilo **/
+    int64_t mtime_sec;      /** Fecha de modificacion del batchfile (segundos) **/
+    int64_t mtime_nsec;     /** Fecha de modificacion del batchfile (nanosegundos) **/
+    uint64_t size;          /** Tamaño del batchfile **/
+    uint64_t inode;         /** Inodo del batchfile **/
+    uint64_t length;        /** Bytes de lineas compiladas a continuacion de la cabecera **/
+    uint64_t checksum;      /** Hash (FNV-1a) de las lineas compiladas, para descartar un archivo dañado **/
+} script_cache_header;
+
+/** Cabecera de cada linea compilada. A continuacion se almacena la linea original y luego los argumentos del
+ * comando interno, o bien para cada etapa su numero de argumentos (uint32_t) seguido de los argumentos terminados en '\0' **/
+typedef struct script_cache_record
+{
+    uint32_t length;        /** Bytes de la linea compilada, incluida la cabecera y el relleno de alineacion **/
+    int32_t command;        /** Identificador del comando interno. -1 para comandos externos **/
+    uint32_t background;    /** Indica si el comando externo se ejecuta en segundo plano **/
+    uint32_t stages;        /** Numero de etapas del comando externo **/
+} script_cache_record;
+
+/** Linea compilada lista para ejecutar **/
+typedef struct script_line
+{
+    char *text;             /** Linea original del batchfile **/
+    int command;            /** Identificador del comando interno. -1 para comandos externos **/
+    char *args;             /** Argumentos del comando interno **/
+    int background;         /** Indica si el comando externo se ejecuta en segundo plano **/
+    int stages;             /** Numero de etapas del comando externo **/
+    char *stage_data;       /** Etapas del comando externo, recorridas con script_cache_stage **/
+} script_line;
+
+/** Batchfile compilado **/
+typedef struct script_cache
+{
+    char *path;             /** Ruta del archivo compilado **/
+    struct stat source;     /** Estado del batchfile al momento de abrirlo **/
+    uint64_t signature;     /** Firma de la tabla de comandos internos **/
+    int loaded;             /** Indica si las lineas se cargaron desde el archivo compilado **/
+    char *data;             /** Lineas compiladas **/
+    size_t length;          /** Bytes de lineas compiladas **/
+    size_t capacity;        /** Capacidad de data mientras se compila **/
+    size_t offset;          /** Posicion de la proxima linea a ejecutar **/
+    void *map;              /** Mapeo del archivo compilado. NULL si las lineas se compilaron en memoria **/
+    size_t map_size;        /** Tamaño del mapeo **/
+} script_cache;
+
+/**
+ * @brief Abre la forma compilada de un batchfile. Si existe un archivo compilado que corresponde a la version actual
+ * del batchfile y a la misma tabla de comandos internos se mapea en memoria. En caso contrario se devuelve vacia para compilarla.
+ *
+ * @param script Ruta del batchfile.
+ * @param signature Firma de la tabla de comandos internos.
+ * @return script_cache* Batchfile compilado. El campo loaded indica si ya contiene las lineas. NULL si no se puede acceder al batchfile.
+ */
+script_cache* script_cache_open(const char *script, uint64_t signature);
+
+/**
+ * @brief Agrega una linea que ejecuta un comando interno.
+ *
+ * @param c Batchfile en compilacion.
+ * @param text Linea original.
+ * @param command Identificador del comando interno.
+ * @param args Argumentos del comando.
+ */
+void script_cache_add_builtin(script_cache *c, const char *text, int command, const char *args);
+
+/**
+ * @brief Agrega una linea que ejecuta un comando externo. La linea se separa en etapas ('|') y cada etapa en sus argumentos.
+ * Un '&' al final de la ultima etapa se elimina y marca la linea para ejecutarse en segundo plano.
+ *
+ * @param c Batchfile en compilacion.
+ * @param text Linea original, que es tambien el comando a separar.
+ */
+void script_cache_add_extern(script_cache *c, const char *text);
+
+/**
+ * @brief Guarda las lineas compiladas junto al batchfile. Se escribe en un archivo temporal que luego se renombra,
+ * por lo que otra shell nunca lee un archivo a medio escribir. Los errores se ignoran: el batchfile se ejecuta igual desde memoria.
+ *
+ * @param c Batchfile compilado.
+ * @return int 0 si se guardo. -1 en caso contrario.
+ */
+int script_cache_save(script_cache *c);
+
+/**
+ * @brief Obtiene la siguiente linea compilada.
+ *
+ * @param c Batchfile compilado.
+ * @param line Donde se almacena la linea. Sus cadenas son validas hasta cerrar el batchfile compilado.
+ * @return int 1 si se obtuvo una linea. 0 si no quedan lineas.
+ */
+int script_cache_next(script_cache *c, script_line *line);
+
+/**
+ * @brief Recorre una etapa de un comando externo compilado.
+ *
+ * @param stage Comienzo de la etapa.
+ * @param argc Donde se almacena el numero de argumentos de la etapa.
+ * @param args Donde se almacena el comienzo de los argumentos, consecutivos y terminados en '\0'.
+ * @return char* Comienzo de la siguiente etapa.
+ */
+char* script_cache_stage(char *stage, int *argc, char **args);
+
+/**
+ * @brief Libera un batchfile compilado.
+ *
+ * @param c Batchfile compilado.
+ */
+void script_cache_close(script_cache *c);
+
+#endif //__SCRIPT_CACHE_H__
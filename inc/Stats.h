@@ -0,0 +1,125 @@
+/**
+ * @file Stats.h
+ * @author Bottini, Franco Nicolas
+ * @brief Histogramas de latencia de las etapas del shell (analisis de la linea, busqueda en PATH, lanzamiento,
+ * espera de los trabajos y reenvio de su salida). Cada etapa se mide con el reloj monotono y se acumula en buckets fijos,
+ * por lo que registrar una muestra no reserva memoria ni recorre el histograma.
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __STATS_H__
+#define __STATS_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "Output.h"
+
+/** Bits de subdivision de cada potencia de 2: cada bucket abarca como maximo 1/16 de su valor (error relativo < 6.25%) **/
+#define HISTOGRAM_SUB_BITS 4
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+
+/** Numero de buckets necesarios para cubrir cualquier valor de 64 bits **/
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+/** Etapas medidas **/
+typedef enum STATS_PHASES
+{
+    STATS_PARSE,        /** Clasificacion y separacion de una linea en comando y argumentos **/
+    STATS_PATH_LOOKUP,  /** Resolucion de un comando en la tabla de rutas **/
+    STATS_LAUNCH,       /** Creacion de un proceso (fork o posix_spawn) **/
+    STATS_WAIT,         /** Espera de un trabajo en primer plano hasta que termina o se suspende **/
+    STATS_DRAIN,        /** Reenvio de la salida disponible en los pipes de un trabajo **/
+    STATS_PHASES_COUNT  /** Numero de etapas **/
+} STATS_PHASES;
+
+/** Histograma de latencias en nanosegundos **/
+typedef struct histogram
+{
+    uint64_t count;                         /** Muestras registradas **/
+    uint64_t sum;                           /** Suma de las muestras **/
+    uint64_t max;                           /** Mayor muestra **/
+    uint64_t buckets[HISTOGRAM_BUCKETS];    /** Muestras por bucket **/
+} histogram;
+
+extern const char* STATS_PHASE_STRING[]; /** String-array de los nombres de las etapas **/
+
+extern histogram stats_histograms[STATS_PHASES_COUNT]; /** Histograma de cada etapa **/
+
+/**
+ * @brief Obtiene el instante actual del reloj monotono.
+ *
+ * @return uint64_t Nanosegundos desde un origen arbitrario.
+ */
+static inline uint64_t stats_now(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (uint64_t) t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+/**
+ * @brief Obtiene el bucket de un valor. Los valores menores a HISTOGRAM_SUB_BUCKETS tienen un bucket propio;
+ * el resto se ubica por su bit mas significativo y los HISTOGRAM_SUB_BITS bits siguientes.
+ *
+ * @param value Valor a ubicar.
+ * @return int Indice del bucket.
+ */
+static inline int histogram_bucket(uint64_t value)
+{
+    if (value < HISTOGRAM_SUB_BUCKETS)
+        return value;
+
+    int msb = 63 - __builtin_clzll(value);
+
+    return (msb - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS + ((value >> (msb - HISTOGRAM_SUB_BITS)) & (HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+/**
+ * @brief Registra en el histograma de una etapa el tiempo transcurrido desde un instante dado.
+ *
+ * @param phase Etapa medida.
+ * @param start Instante en que comenzo la etapa, obtenido con stats_now.
+ */
+static inline void stats_record(STATS_PHASES phase, uint64_t start)
+{
+    histogram *h = &stats_histograms[phase];
+    uint64_t elapsed = stats_now() - start;
+
+    h->count++;
+    h->sum += elapsed;
+    h->buckets[histogram_bucket(elapsed)]++;
+
+    if (elapsed > h->max)
+        h->max = elapsed;
+}
+
+/**
+ * @brief Obtiene un percentil de un histograma. Se devuelve el limite superior del bucket que lo contiene, acotado por el maximo.
+ *
+ * @param h Histograma a consultar.
+ * @param p Percentil buscado, entre 0 y 1.
+ * @return uint64_t Valor del percentil. 0 si el histograma esta vacio.
+ */
+uint64_t histogram_percentile(const histogram *h, double p);
+
+/**
+ * @brief Descarta todas las muestras registradas.
+ *
+ */
+void stats_reset(void);
+
+/**
+ * @brief Imprime por consola el numero de muestras, la media, p50, p99 y el maximo de cada etapa, en microsegundos.
+ *
+ */
+void print_stats(void);
+
+#endif //__STATS_H__
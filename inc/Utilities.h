@@ -0,0 +1,69 @@
+/**
+ * @file Utilities.h
+ * @author Bottini, Franco Nicolas
+ * @brief Implementacion dentro del shell de las utilidades mas usadas en los batchfiles (true, false, pwd, printf, test, kill y sleep),
+ * segun su comportamiento POSIX. Evitan crear un proceso por cada una de estas lineas.
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __UTILITIES_H__
+#define __UTILITIES_H__
+
+#include <stdio.h>
+
+/** Codigo de salida de test ante una expresion invalida **/
+#define TEST_ERROR 2
+
+/** Secuencia que limpia la terminal, la misma que emite clear **/
+#define CLEAR_SCREEN_SEQUENCE "\x1B[H\x1B[2J\x1B[3J"
+
+/**
+ * @brief Separa los argumentos de un comando en sus espacios, en el mismo buffer.
+ *
+ * @param args Argumentos a separar.
+ * @param argc Donde se almacena el numero de argumentos.
+ * @return char** Array de argumentos terminado en NULL. Se debe liberar con free.
+ */
+char** split_arguments(char* args, int* argc);
+
+/**
+ * @brief Emite la salida de una utilidad con el mismo formato que la de un programa externo reenviada por el shell.
+ *
+ * @param data Salida de la utilidad.
+ * @param len Longitud de la salida.
+ */
+void utility_output(const char* data, size_t len);
+
+/**
+ * @brief Evalua una expresion de test siguiendo las reglas POSIX segun el numero de argumentos.
+ *
+ * @param argv Argumentos de la expresion.
+ * @param argc Numero de argumentos.
+ * @return int 0 si es verdadera, 1 si es falsa, TEST_ERROR si es invalida.
+ */
+int test_evaluate(char** argv, int argc);
+
+/**
+ * @brief Escribe los argumentos segun el formato de printf.
+ *
+ * @param out Flujo donde escribir.
+ * @param format Formato.
+ * @param argv Argumentos a formatear.
+ * @param argc Numero de argumentos.
+ * @return int 0 si todos los argumentos se convirtieron correctamente. 1 en caso contrario.
+ */
+int printf_format(FILE* out, const char* format, char** argv, int argc);
+
+/**
+ * @brief Obtiene el numero de una señal a partir de su nombre (con o sin el prefijo SIG) o de su numero.
+ *
+ * @param name Nombre o numero de la señal.
+ * @return int Numero de la señal. -1 si no existe.
+ */
+int signal_from_name(const char* name);
+
+#endif //__UTILITIES_H__
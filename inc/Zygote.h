@@ -0,0 +1,88 @@
+/**
+ * @file Zygote.h
+ * @author Bottini, Franco Nicolas
+ * @brief Proceso auxiliar que lanza los procesos de los trabajos en lugar del shell. Se crea al inicializar el control de trabajos,
+ * cuando el espacio de direcciones del shell todavia es pequeño, y recibe cada pedido (ruta, argumentos, grupo de procesos,
+ * redirecciones, politica de planificacion y descriptores mediante SCM_RIGHTS) por un socket Unix. Los procesos se crean con CLONE_PARENT, por lo que son hijos del shell:
+ * el shell los espera con wait4 y recibe sus SIGCHLD igual que con los demas mecanismos de lanzamiento.
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef __ZYGOTE_H__
+#define __ZYGOTE_H__
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#include "Policy.h"
+
+/** Tamaño maximo de un pedido. Los comandos con argumentos mas largos se lanzan sin el zygote **/
+#define ZYGOTE_REQUEST_SIZE (64 * 1024)
+
+/** Descriptores enviados con cada pedido: entrada, salida y salida de errores del proceso **/
+#define ZYGOTE_FDS 3
+
+/** Resultado de zygote_launch cuando el zygote no puede atender el pedido **/
+#define ZYGOTE_UNAVAILABLE -2
+
+/** Cabecera de un pedido. A continuacion se envian la ruta resuelta (si la hay), los argumentos y los archivos redirigidos,
+ * terminados en '\0'. Solo se envian los descriptores de los flujos que no se redirigen, en orden **/
+typedef struct zygote_request
+{
+    pid_t pgid;                         /** Grupo de procesos del trabajo. 0 para que el proceso cree uno propio **/
+    uint32_t argc;                      /** Numero de argumentos **/
+    uint32_t has_path;                  /** Indica si los datos comienzan con la ruta del ejecutable **/
+    int32_t redirect_flags[ZYGOTE_FDS]; /** Flags de apertura del archivo redirigido de cada flujo. -1 si se usa el descriptor enviado **/
+    job_policy policy;                  /** Politica de planificacion que se aplica al proceso antes de exec **/
+} zygote_request;
+
+/**
+ * @brief Crea el zygote. Si el proceso actual ya tiene uno, se reemplaza.
+ *
+ * @return int 0 si el zygote se creo. -1 en caso de error.
+ */
+int zygote_start(void);
+
+/**
+ * @brief Cierra la conexion con el zygote, que finaliza al detectarlo.
+ *
+ */
+void zygote_stop(void);
+
+/**
+ * @brief Lanza un proceso a traves del zygote. Si el proceso actual no creo el zygote (por ejemplo, una copia del shell
+ * creada con fork) se crea uno propio, ya que los procesos se entregan como hijos del creador del zygote.
+ *
+ * @param path Ruta del ejecutable. NULL para buscar argv[0] en PATH.
+ * @param argv Argumentos del proceso.
+ * @param argc Numero de argumentos.
+ * @param pgid Grupo de procesos. 0 para que el proceso cree uno propio.
+ * @param fds Entrada, salida y salida de errores del proceso. Se ignoran los de los flujos redirigidos.
+ * @param redirect Archivo al que se redirige cada flujo. NULL si no se redirige.
+ * @param redirect_flags Flags de apertura de cada archivo redirigido.
+ * @param policy Politica de planificacion del proceso.
+ * @return pid_t PID del proceso. -1 si el zygote no pudo crearlo. ZYGOTE_UNAVAILABLE si el pedido no se pudo enviar.
+ */
+pid_t zygote_launch(const char *path, char **argv, int argc, pid_t pgid, const int fds[ZYGOTE_FDS],
+                    const char *const redirect[ZYGOTE_FDS], const int redirect_flags[ZYGOTE_FDS], const job_policy *policy);
+
+#endif //__ZYGOTE_H__
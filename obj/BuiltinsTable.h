@@ -0,0 +1,15 @@
+/* Generado por tools/BuiltinsGen.c a partir de inc/Builtins.def. No editar. */
+
+#ifndef __BUILTINS_TABLE_H__
+#define __BUILTINS_TABLE_H__
+
+/** Semilla del hash de los nombres de comandos internos **/
+#define BUILTIN_HASH_SEED 24u
+
+/** Mascara para obtener la posicion en la tabla a partir del hash **/
+#define BUILTIN_HASH_MASK 63u
+
+/** Comando interno de cada posicion de la tabla. -1 si la posicion esta libre **/
+static const signed char BUILTIN_SLOTS[64] = { -1, 18, -1, -1, -1, -1, -1, 14, -1, -1, -1, 13, -1, 4, -1, -1, 9, 7, -1, 5, -1, 2, 15, -1, -1, -1, -1, -1, 17, -1, 3, 6, -1, -1, -1, -1, 12, -1, -1, -1, 10, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, 0, -1, -1, -1, -1, 1 };
+
+#endif //__BUILTINS_TABLE_H__
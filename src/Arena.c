@@ -0,0 +1,69 @@
+/**
+ * @file Arena.c
+ * @author Bottini, Franco Nicolas
+ * @brief Implementacion del asignador de memoria por regiones.
+ * @version 1.2
+ * @date Septiembre de 2022
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/Arena.h"
+
+arena* arena_create(void)
+{
+    arena *a = malloc(sizeof(arena) + sizeof(arena_block) + ARENA_BLOCK_SIZE);
+    arena_block *first = (arena_block*) (a + 1);
+
+    first->next = NULL;
+    first->size = ARENA_BLOCK_SIZE;
+    first->used = 0;
+    a->blocks = first;
+
+    return a;
+}
+
+void* arena_alloc(arena *a, size_t size)
+{
+    size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+
+    if (a->blocks->used + size > a->blocks->size)
+    {
+        size_t block_size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+        arena_block *block = malloc(sizeof(arena_block) + block_size);
+
+        block->next = a->blocks;
+        block->size = block_size;
+        block->used = 0;
+        a->blocks = block;
+    }
+
+    void *ptr = (char*) a->blocks->data + a->blocks->used;
+    a->blocks->used += size;
+
+    return ptr;
+}
+
+char* arena_strdup(arena *a, const char* str)
+{
+    size_t len = strlen(str) + 1;
+
+    return memcpy(arena_alloc(a, len), str, len);
+}
+
+void arena_destroy(arena *a)
+{
+    arena_block *first = (arena_block*) (a + 1);
+
+    //El primer bloque forma parte de la misma reserva que la region.
+    while (a->blocks != first)
+    {
+        arena_block *next = a->blocks->next;
+
+        free(a->blocks);
+        a->blocks = next;
+    }
+
+    free(a);
+}
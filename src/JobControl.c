@@ -16,60 +16,253 @@ const char* PROCESS_STATUS_STRING[] = {
     "done",
     "suspended",
     "continued",
-    "terminated"
+    "terminated",
+    "new",
+    "ready",
+    "queued"
 };
 
-job *first_job = NULL;
+job **job_table = NULL;
+int job_table_size = 0;
+int job_table_max = 0;
+int job_count = 0;
 
-job* new_job(process *first_process)
+process **pid_index = NULL;
+size_t pid_index_size = 0;
+size_t pid_index_count = 0;
+
+LAUNCH_BACKENDS launch_backend = LAUNCH_BACKEND_DEFAULT;
+
+int background_max = 0;
+int background_running = 0;
+job *job_queue_head = NULL;
+job *job_queue_tail = NULL;
+
+job_policy background_policy;
+
+int sigchld_fd = -1;
+
+int shell_terminal = -1;
+
+job* new_job(void)
 {
-    job* j = malloc(sizeof(job));
+    arena* a = arena_create();
+    job* j = arena_alloc(a, sizeof(job));
 
+    j->arena = a;
     j->id = 0;
-    j->next = NULL;
     j->pgid = -1;
-    j->first_process = first_process;
-    j->first_process->status = STATUS_READY;
+    j->io_fd[0] = j->io_fd[1] = -1;
+    j->err_fd[0] = j->err_fd[1] = -1;
+    j->first_process = NULL;
+    j->mode = FOREGROUND_EXECUTION;
+    j->timed = 0;
+    j->slot = 0;
+    j->queued = 0;
+    j->next_queued = NULL;
+    policy_clear(&j->policy);
+    ring_init(&j->output, NULL, 0);
+    j->output_shown = 0;
+
+    return j;
+}
+
+void update_job_mode(job *j)
+{
+    process* last_process = get_last_process(j);
+
+    if (!last_process)
+        return;
 
-    if(!strcmp(j->first_process->argv[j->first_process->argc - 1], "&"))
+    //El '&' que envia el trabajo a segundo plano se encuentra al final del ultimo proceso.
+    if(last_process->argc > 0 && !strcmp(last_process->argv[last_process->argc - 1], "&"))
     {
         j->mode = BACKGROUND_EXECUTION;
-        free(j->first_process->argv[j->first_process->argc]);
-        j->first_process->argv[j->first_process->argc - 1] = NULL;
+        last_process->argv[--last_process->argc] = NULL;
     }
+    else if (j->first_process->next)
+        j->mode = PIPELINE_EXECUTION;
     else
         j->mode = FOREGROUND_EXECUTION;
+}
 
-    return j;
+process* new_process(job *j, char *command)
+{
+    process *p = arena_alloc(j->arena, sizeof(process));
+
+    p->next = NULL;
+    p->argv = str_to_array(j->arena, command, &p->argc);
+    p->status = STATUS_READY;
+    p->pid = -1;
+    p->path = NULL;
+    p->wait_status = 0;
+    memset(&p->usage, 0, sizeof(p->usage));
+    memset(&p->started, 0, sizeof(p->started));
+    p->finished = p->started;
+    memset(p->redirect, 0, sizeof(p->redirect));
+
+    //Un operador sin archivo invalida el proceso, igual que una etapa vacia.
+    if (parse_redirections(p) < 0)
+        p->argv[p->argc = 0] = NULL;
+
+    insert_process(j, p);
+
+    return p;
 }
 
-process* new_process(char *command)
+process* new_process_argv(job *j, char *args, int argc)
 {
-    process *p = malloc(sizeof(process));
+    process *p = arena_alloc(j->arena, sizeof(process));
+    size_t len = 0;
+
+    for (int i = 0; i < argc; i++)
+        len += strlen(args + len) + 1;
+
+    //Los argumentos ya separados se copian en un solo bloque a la region del trabajo.
+    char *copy = arena_alloc(j->arena, len);
+
+    memcpy(copy, args, len);
 
     p->next = NULL;
-    p->argv = str_to_array(command, &p->argc);
-    p->status = STATUS_NEW;
+    p->argc = argc;
+    p->argv = arena_alloc(j->arena, sizeof(char*) * (argc + 1));
+    p->status = STATUS_READY;
     p->pid = -1;
+    p->path = NULL;
+    p->wait_status = 0;
+    memset(&p->usage, 0, sizeof(p->usage));
+    memset(&p->started, 0, sizeof(p->started));
+    p->finished = p->started;
+    memset(p->redirect, 0, sizeof(p->redirect));
+
+    for (int i = 0; i < argc; i++)
+    {
+        p->argv[i] = copy;
+        copy += strlen(copy) + 1;
+    }
+
+    p->argv[argc] = NULL;
+
+    if (parse_redirections(p) < 0)
+        p->argv[p->argc = 0] = NULL;
+
+    insert_process(j, p);
 
     return p;
 }
 
-int insert_job(job *j) 
+int parse_redirection_operator(char **arg, int *flags)
 {
-    job *last_job = get_last_job();
+    char *c = *arg;
+    int fd = STDOUT_FILENO;
 
-    if(!last_job)
+    if (c[0] == '2' && c[1] == '>')
     {
-        j->id  = 1;
-        first_job = j;
+        fd = STDERR_FILENO;
+        c++;
+    }
+
+    if (*c == '<')
+    {
+        fd = STDIN_FILENO;
+        *flags = O_RDONLY;
+        c++;
+    }
+    else if (c[0] == '>' && c[1] == '>')
+    {
+        *flags = O_WRONLY | O_CREAT | O_APPEND;
+        c += 2;
+    }
+    else if (*c == '>')
+    {
+        *flags = O_WRONLY | O_CREAT | O_TRUNC;
+        c++;
     }
     else
+        return -1;
+
+    *arg = c;
+
+    return fd;
+}
+
+int parse_redirections(process *p)
+{
+    int argc = 0;
+
+    for (int i = 0; i < p->argc; i++)
+    {
+        char *arg = p->argv[i];
+        int flags, fd = parse_redirection_operator(&arg, &flags);
+
+        if (fd < 0)
+        {
+            p->argv[argc++] = p->argv[i];
+            continue;
+        }
+
+        //El archivo puede estar pegado al operador ("<in", ">out") o ser el argumento siguiente.
+        if (*arg == '\0')
+        {
+            if (i + 1 >= p->argc)
+                return -1;
+
+            arg = p->argv[++i];
+        }
+
+        p->redirect[fd] = arg;
+        p->redirect_flags[fd] = flags;
+    }
+
+    p->argc = argc;
+    p->argv[argc] = NULL;
+
+    return 0;
+}
+
+int open_redirections(process *p)
+{
+    for (int fd = 0; fd < STANDARD_STREAMS; fd++)
+    {
+        if (!p->redirect[fd])
+            continue;
+
+        int file_fd = open(p->redirect[fd], p->redirect_flags[fd], REDIRECT_FILE_MODE);
+
+        if (file_fd < 0)
+        {
+            fprintf(stderr, "%s: %s\n", p->redirect[fd], strerror(errno));
+            return -1;
+        }
+
+        if (file_fd != fd)
+        {
+            dup2(file_fd, fd);
+            close(file_fd);
+        }
+    }
+
+    return 0;
+}
+
+int insert_job(job *j) 
+{
+    //Los IDs siguen siendo consecutivos al ultimo trabajo de la tabla.
+    j->id = job_table_max + 1;
+
+    if (j->id >= job_table_size)
     {
-        j->id = last_job->id + 1;
-        last_job->next = j;
+        int new_size = job_table_size ? job_table_size * 2 : JOB_TABLE_INITIAL_SIZE;
+
+        job_table = realloc(job_table, sizeof(job*) * new_size);
+        memset(job_table + job_table_size, 0, sizeof(job*) * (new_size - job_table_size));
+        job_table_size = new_size;
     }
 
+    job_table[j->id] = j;
+    job_table_max = j->id;
+    job_count++;
+
     return j->id;
 }
 
@@ -77,6 +270,8 @@ void insert_process(job *j, process *p)
 {
     process *last_p = get_last_process(j);
 
+    p->job = j;
+
     if(!last_p)
         j->first_process = p;
     else
@@ -85,87 +280,125 @@ void insert_process(job *j, process *p)
 
 void remove_job(job* j) 
 {
-    if (!first_job)
-        return;
-
-    job *parent = get_job_parent(j);
-
-    if(!parent)
+    if (j->id > 0 && j->id <= job_table_max && job_table[j->id] == j)
     {
-        first_job = j->next;
-        free_job(j);
-        return;
-    }
+        job_table[j->id] = NULL;
+        job_count--;
 
-    if(j->next == NULL)
-    {
-        parent->next = NULL;
-        free_job(j);
-        return;
+        while (job_table_max > 0 && !job_table[job_table_max])
+            job_table_max--;
     }
 
-    parent->next = j->next;
+    for (process* p = j->first_process; p; p = p->next)
+        pid_index_remove(p->pid);
+
+    if (j->slot)
+        background_running--;
+
     free_job(j);
-    return;
 }
 
 job* get_last_job() 
 {
-    job* last_j = first_job;
+    return job_table_max > 0 ? job_table[job_table_max] : NULL;
+}
 
-    if(!last_j)
-        return NULL;
-    
-    while (last_j->next)
-        last_j = last_j->next;
+int get_jobs_count(void)
+{
+    return job_count;
+}
+
+int get_queued_jobs_count(void)
+{
+    int count = 0;
+
+    for (job *j = job_queue_head; j; j = j->next_queued)
+        count++;
 
-    return last_j;
+    return count;
 }
 
 job* get_job_by_pid(int pid)
 {
-    int id = get_job_id_by_pid(pid);
+    process* p = get_process_by_pid(pid);
 
-    if(id == -1)
-        return NULL;
-    
-    return get_job_by_id(id);
+    return p ? p->job : NULL;
 }
 
 job* get_job_by_id(int id)
 {
-    job* j = first_job;
-
-    if(!j)
+    if (id <= 0 || id > job_table_max)
         return NULL;
 
-    while (j->id != id)
-        j = j->next;
+    return job_table[id];
+}
 
-    return j;
+int get_job_id_by_pid(int pid) 
+{    
+    job* j = get_job_by_pid(pid);
+
+    return j ? j->id : -1;
 }
 
-job* get_job_parent(job *j)
+static size_t pid_slot(pid_t pid)
 {
-    job *parent = first_job;
+    return ((size_t) pid * 2654435761UL) & (pid_index_size - 1);
+}
 
-    if(!parent || j == parent)
-        return NULL;
+void pid_index_insert(process *p)
+{
+    if ((pid_index_count + 1) * 2 > pid_index_size)
+    {
+        process **old_index = pid_index;
+        size_t old_size = pid_index_size;
 
-    while (parent->next != j)
-        parent = parent->next;
-    
-    return parent;
+        pid_index_size = old_size ? old_size * 2 : PID_INDEX_INITIAL_SIZE;
+        pid_index = calloc(pid_index_size, sizeof(process*));
+        pid_index_count = 0;
+
+        for (size_t i = 0; i < old_size; i++)
+            if (old_index[i])
+                pid_index_insert(old_index[i]);
+
+        free(old_index);
+    }
+
+    size_t i = pid_slot(p->pid);
+
+    while (pid_index[i] && pid_index[i]->pid != p->pid)
+        i = (i + 1) & (pid_index_size - 1);
+
+    if (!pid_index[i])
+        pid_index_count++;
+
+    pid_index[i] = p;
 }
 
-int get_job_id_by_pid(int pid) 
-{    
-    for (job* j = first_job; j; j = j->next) 
-        for (process* p = j->first_process; p; p = p->next) 
-            if (p->pid == pid) 
-                return j->id;
+void pid_index_remove(pid_t pid)
+{
+    if (pid <= 0 || !pid_index_size)
+        return;
+
+    size_t i = pid_slot(pid);
+
+    while (pid_index[i] && pid_index[i]->pid != pid)
+        i = (i + 1) & (pid_index_size - 1);
+
+    if (!pid_index[i])
+        return;
 
-    return -1;
+    pid_index[i] = NULL;
+    pid_index_count--;
+
+    //Reubica el resto del cluster para no cortar las secuencias de sondeo.
+    for (i = (i + 1) & (pid_index_size - 1); pid_index[i]; i = (i + 1) & (pid_index_size - 1))
+    {
+        process *moved = pid_index[i];
+
+        pid_index[i] = NULL;
+        pid_index_count--;
+        pid_index_insert(moved);
+    }
 }
 
 void set_job_status(job *j, PROCESS_STATUS status)
@@ -178,7 +411,7 @@ void set_job_status(job *j, PROCESS_STATUS status)
 int is_job_completed(job *j) 
 {
     for (process* p = j->first_process; p != NULL; p = p->next) 
-        if (p->status != STATUS_DONE)
+        if (p->status != STATUS_DONE && p->status != STATUS_TERMINATED)
             return 0;
 
     return 1;
@@ -199,20 +432,15 @@ process* get_last_process(job *j)
 
 process* get_process_by_pid(int pid)
 {
-    job* j = get_job_by_pid(pid);
-
-    if(!j)
+    if (pid <= 0 || !pid_index_size)
         return NULL;
 
-    process* p = j->first_process;
-
-    if(!p)
-        return NULL;
+    size_t i = pid_slot(pid);
 
-    while (p->pid != pid)
-        p = p->next;
+    while (pid_index[i] && pid_index[i]->pid != pid)
+        i = (i + 1) & (pid_index_size - 1);
 
-    return p;
+    return pid_index[i];
 }
 
 int get_processes_count(job* j, int filter) 
@@ -222,7 +450,9 @@ int get_processes_count(job* j, int filter)
     for (process* p = j->first_process; p; p = p->next)
         if (filter == PROC_FILTER_ALL ||
            (filter == PROC_FILTER_DONE && p->status == STATUS_DONE) ||
-           (filter == PROC_FILTER_REMAINING && p->status != STATUS_DONE))
+           (filter == PROC_FILTER_REMAINING && p->status != STATUS_DONE) ||
+           (filter == PROC_FILTER_RUNNING && (p->status == STATUS_RUNNING || p->status == STATUS_CONTINUED)) ||
+           (filter == PROC_FILTER_SUSPENDED && p->status == STATUS_SUSPENDED))
             count++;
 
     return count;
@@ -235,286 +465,1246 @@ void set_process_status(process *p, PROCESS_STATUS status)
 
 void job_control_init()
 {
-    struct sigaction sigint_action = {
-        .sa_handler = sigint_handler,
-        .sa_flags = 0
-    };
-    sigemptyset(&sigint_action.sa_mask);
-    sigaction(SIGCHLD, &sigint_action, NULL);
+    set_launch_backend(getenv("MYSHELL_LAUNCH"));
+
+    //Por defecto se ejecutan a la vez tantos trabajos en segundo plano como CPUs disponibles.
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    background_max = cpus > 0 ? cpus : 1;
+
+    //Los trabajos en segundo plano se reparten entre las CPUs disponibles en orden round-robin.
+    policy_setup();
+    policy_clear(&background_policy);
+    background_policy.automatic = 1;
+
+    //SIGCHLD queda bloqueada de forma permanente y se atiende de forma sincronica a traves de un signalfd.
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &mask, NULL);
+
+    sigchld_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
 
-    pid_t pid = getpid();
-    setpgid(pid, pid);
-    tcsetpgrp(0, pid);
+    //Solo se toma el control de la terminal si la entrada estandar es una.
+    shell_terminal = isatty(STDIN_FILENO) ? STDIN_FILENO : -1;
+
+    //Sin terminal el shell permanece en el grupo de procesos de quien lo lanzo (por ejemplo, su pipeline), que recibe el Ctrl-C.
+    if (shell_terminal >= 0)
+    {
+        pid_t pid = getpid();
+
+        setpgid(pid, pid);
+        tcsetpgrp(shell_terminal, pid);
+    }
+
+    //El zygote se crea mientras el espacio de direcciones del shell es minimo.
+    if (launch_backend == LAUNCH_ZYGOTE)
+        zygote_start();
 }
 
-void sigint_handler(int signal)
+int reap_children(void)
 {
-    int status, pid;
+    struct signalfd_siginfo info[16];
+    int status, pid, notified = 0;
+    struct rusage usage;
+
+    //Las señales pendientes se descartan: varias SIGCHLD pueden fusionarse en una, por eso se consulta waitpid hasta agotar los hijos.
+    while (read(sigchld_fd, info, sizeof(info)) > 0);
 
-    while ((pid = waitpid(WAIT_ANY, &status, WNOHANG|WUNTRACED|WCONTINUED)) > 0) 
+    while ((pid = wait4(WAIT_ANY, &status, WNOHANG|WUNTRACED|WCONTINUED, &usage)) > 0) 
     {
         job *j = get_job_by_pid(pid);
         process *p = get_process_by_pid(pid);
 
-        if (WIFEXITED(status))
-            set_process_status(p, STATUS_DONE);
-        else if (WIFSTOPPED(status))
-            set_process_status(p, STATUS_SUSPENDED);
-        else if (WIFCONTINUED(status))
-            set_process_status(p, STATUS_CONTINUED);
+        if (!j || !p)
+            continue;
 
-        fprintf(stdout, "\n\n");
+        update_process_status(p, status, &usage);
 
-        print_job_pipe(j);
+        //Los trabajos en primer plano los atiende wait_for_job.
+        if (j->mode != BACKGROUND_EXECUTION)
+            continue;
 
-        if (j->id > 0 && is_job_completed(j)) 
+        //La salida se conserva en el buffer del trabajo y solo se muestra, la que no se haya leido con output, al terminar.
+        collect_job_output(j);
+
+        if (is_job_completed(j)) 
         {
+            //La primera notificacion se separa de lo que haya en la linea actual (por ejemplo el prompt).
+            if (!notified)
+                output_puts("\n");
+
+            if (print_job_output(j, j->output_shown))
+                output_puts("\n");
+
             print_job_status(j);
+
+            if (j->timed)
+            {
+                job_usage u;
+
+                get_job_usage(j, &u);
+                print_usage(&u, j->id);
+            }
+
             remove_job(j);
+            notified++;
         }
     }
 
-    fprintf(stdout, "\n");
+    if (notified)
+    {
+        output_puts("\n");
+        output_flush();
+    }
+
+    //Los lugares liberados por los trabajos terminados se ocupan con los trabajos en espera.
+    if (job_queue_head)
+        dispatch_queued_jobs();
+
+    return notified;
 }
 
-int wait_for_job(job *j)
+int process_job_events(int timeout)
 {
-    int proc_count = get_processes_count(j, PROC_FILTER_REMAINING);
-    int wait_count = 0;
-    int status = 0;
+    struct pollfd fd = { .fd = sigchld_fd, .events = POLLIN };
 
-    do 
-    {
-        int wait_pid = waitpid(-j->pgid, &status, WUNTRACED);
-        process *p = get_process_by_pid(wait_pid);
+    if (poll_events(&fd, 1, timeout) <= 0 || !(fd.revents & POLLIN))
+        return 0;
+
+    return reap_children();
+}
+
+int wait_for_all_jobs(int timeout)
+{
+    struct timespec now, deadline;
 
-        wait_count++;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += (timeout % 1000) * 1000000L;
 
-        if (WIFEXITED(status))
-            set_process_status(p, STATUS_DONE);
-        else if (WIFSIGNALED(status))
-            set_process_status(p, STATUS_TERMINATED);
-        else if (WSTOPSIG(status)) 
+    reap_children();
+
+    //Los trabajos suspendidos no pueden avanzar por si solos, no tiene sentido esperarlos.
+    while (get_running_jobs_count() > 0)
+    {
+        int remaining = -1;
+
+        if (timeout >= 0)
         {
-            status = -1;
-            set_process_status(p, STATUS_SUSPENDED);
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            remaining = (deadline.tv_sec - now.tv_sec) * 1000 + (deadline.tv_nsec - now.tv_nsec) / 1000000L;
 
-            if (wait_count == proc_count)
-                print_job_status(j);
+            if (remaining <= 0)
+                break;
         }
-    } while (wait_count < proc_count);
 
-    return status;
+        process_job_events(remaining);
+    }
+
+    return get_running_jobs_count();
 }
 
-int wait_for_process(process *p)
+int get_running_jobs_count(void)
 {
-    int status = 0;
+    int count = 0;
 
-    waitpid(p->pid, &status, WUNTRACED);
+    for (int id = 1; id <= job_table_max; id++)
+        if (job_table[id] && (job_table[id]->queued || get_processes_count(job_table[id], PROC_FILTER_RUNNING) > 0))
+            count++;
 
-    if (WIFEXITED(status))
-        set_process_status(p, STATUS_DONE);
-    else if (WIFSIGNALED(status))
-        set_process_status(p, STATUS_TERMINATED);
-    else if (WSTOPSIG(status)) 
-    {
-        status = -1;
-        set_process_status(p, STATUS_SUSPENDED);
-    }
+    return count;
+}
 
-    return status;
+void kill_all_jobs(int signal)
+{
+    //Los trabajos en espera nunca se lanzaron: se descartan para que no ocupen los lugares que se liberen.
+    while (job_queue_head)
+        cancel_queued_job(job_queue_head);
+
+    for (int id = 1; id <= job_table_max; id++)
+        if (job_table[id] && job_table[id]->pgid > 0)
+        {
+            kill(-job_table[id]->pgid, signal);
+            kill(-job_table[id]->pgid, SIGCONT);
+        }
 }
 
-int launch_job(job *j) 
+int wait_for_input(int fd)
 {
-    int status = 0;
-    
-    insert_job(j);
+    struct pollfd fds[2] = {
+        { .fd = fd, .events = POLLIN },
+        { .fd = sigchld_fd, .events = POLLIN }
+    };
 
-    if (pipe(j->io_fd) < 0 || pipe(j->err_fd) < 0)
+    while (1)
     {
-        perror(KRED"\npipe\n"KDEF);
-        exit (EXIT_FAILURE);
-    }
+        if (poll_events(fds, 2, -1) < 0 && errno != EINTR)
+            return 0;
 
-    for (process* p = j->first_process; p; p = p->next)
-        status = launch_process(j, p);
+        if (fds[1].revents & POLLIN)
+        {
+            int notified = reap_children();
 
-    if (status >= 0 && j->mode == FOREGROUND_EXECUTION)
-        remove_job(j);
-    if (j->mode == BACKGROUND_EXECUTION)
-        print_job_process(j);
+            if (notified)
+                return notified;
+        }
 
-    return status;
+        if (fds[0].revents)
+            return 0;
+    }
 }
 
-int launch_process(job *j, process *p) 
+int poll_events(struct pollfd *fds, nfds_t nfds, int timeout)
 {
-    p->status = STATUS_RUNNING;
+    static struct pollfd *events = NULL;
+    static size_t events_size = 0;
+    size_t needed = nfds + 2 * job_count;
+    nfds_t n = nfds;
 
-    int status = 0;
-    pid_t childpid = fork();
+    if (needed > events_size)
+    {
+        events_size = needed * 2;
+        events = realloc(events, sizeof(struct pollfd) * events_size);
+    }
 
-    if (childpid < 0)
-        return -1;
-    else if (childpid == 0)
+    memcpy(events, fds, sizeof(struct pollfd) * nfds);
+
+    //Los pipes de los trabajos en segundo plano se agregan a continuacion de los descriptores del llamador.
+    for (int id = 1; id <= job_table_max && job_count > 0; id++)
     {
-        signal(SIGINT, SIG_DFL);
-        signal(SIGQUIT, SIG_DFL);
-        signal(SIGTSTP, SIG_DFL);
-        signal(SIGTTIN, SIG_DFL);
-        signal(SIGTTOU, SIG_DFL);
-        signal(SIGCHLD, SIG_DFL);
+        job *j = job_table[id];
 
-        p->pid = getpid();
-        if (j->pgid <= 0)
-            j->pgid = p->pid;
+        if (!j || j->mode != BACKGROUND_EXECUTION)
+            continue;
 
-        setpgid(0, j->pgid);
+        if (j->io_fd[0] >= 0)
+            events[n++] = (struct pollfd) { .fd = j->io_fd[0], .events = POLLIN };
+        if (j->err_fd[0] >= 0)
+            events[n++] = (struct pollfd) { .fd = j->err_fd[0], .events = POLLIN };
+    }
 
-        close(j->io_fd[0]);
-        dup2(j->io_fd[1], STDOUT_FILENO);
-        close(j->io_fd[1]);
+    int result = poll(events, n, timeout);
 
-        close(j->err_fd[0]);
-        dup2(j->err_fd[1], STDERR_FILENO);
-        close(j->err_fd[1]);
+    memcpy(fds, events, sizeof(struct pollfd) * nfds);
 
-        if (execvp(p->argv[0], p->argv) < 0) 
+    for (nfds_t i = nfds; result > 0 && i < n; i++)
+        if (events[i].revents)
         {
-            fprintf(stderr, "Command not found!\n");
-            exit(EXIT_FAILURE);
+            collect_background_output();
+            break;
         }
 
-        exit(EXIT_SUCCESS);
-    } 
-    else 
+    return result;
+}
+
+void collect_background_output(void)
+{
+    for (int id = 1; id <= job_table_max; id++)
+        if (job_table[id] && job_table[id]->mode == BACKGROUND_EXECUTION)
+            collect_job_output(job_table[id]);
+}
+
+size_t collect_job_output(job *j)
+{
+    static char buffer[RELAY_BUFFER_SIZE];
+    int *fds[] = { &j->err_fd[0], &j->io_fd[0] };
+    size_t total = 0;
+    uint64_t start = stats_now();
+
+    for (size_t i = 0; i < sizeof(fds) / sizeof(*fds); i++)
     {
-        p->pid = childpid;
+        ssize_t n;
 
-        if (j->pgid <= 0)
-            j->pgid = p->pid;
+        if (*fds[i] < 0)
+            continue;
 
-        setpgid(childpid, j->pgid);
-        
-        if (j->mode == FOREGROUND_EXECUTION) 
+        while ((n = read(*fds[i], buffer, sizeof(buffer))) > 0)
         {
-            tcsetpgrp(0, j->pgid);
-            status = wait_for_job(j);
-            signal(SIGTTOU, SIG_IGN);
-            tcsetpgrp(0, getpid());
-            signal(SIGTTOU, SIG_DFL);
+            //El buffer se reserva recien con la primera salida: la mayoria de los trabajos no escribe nada.
+            if (!j->output.data)
+                ring_init(&j->output, arena_alloc(j->arena, JOB_OUTPUT_SIZE), JOB_OUTPUT_SIZE);
+
+            ring_write(&j->output, buffer, n);
+            total += n;
+        }
 
-            print_job_pipe(j);
+        if (n == 0)
+        {
+            close(*fds[i]);
+            *fds[i] = -1;
         }
     }
 
-    return status;
+    if (total)
+        stats_record(STATS_DRAIN, start);
+
+    return total;
 }
 
-void print_job_all_status(void) 
+size_t print_job_output(job *j, uint64_t from)
 {
-    fprintf(stdout, "\n");
+    struct iovec iov[4];
+    uint64_t first = ring_first(&j->output);
+    int colored = isatty(STDOUT_FILENO);
+    int count = 0;
 
-    for (job* j = first_job; j; j = j->next)
-        print_job_status(j);
+    //Si se descarto parte de la salida, se muestra a partir de la primera linea completa.
+    if (from < first)
+    {
+        first = ring_next_line(&j->output, first);
+        output_printf(KBLU"[%d] %llu bytes of output discarded\n"KDEF, j->id, (unsigned long long) (first - from));
+        from = first;
+    }
 
-    fprintf(stdout, "\n");
-}
+    //Vacia la salida pendiente antes de escribir directamente sobre el descriptor.
+    output_flush();
+
+    if (colored)
+        iov[count++] = (struct iovec) { .iov_base = KYEL, .iov_len = strlen(KYEL) };
+
+    int segments = ring_segments(&j->output, from, iov + count);
+    size_t total = 0;
+
+    for (int i = 0; i < segments; i++)
+        total += iov[count + i].iov_len;
+
+    count += segments;
+
+    if (colored)
+        iov[count++] = (struct iovec) { .iov_base = KDEF, .iov_len = strlen(KDEF) };
+
+    if (total)
+        write_all_iov(STDOUT_FILENO, iov, count);
+
+    j->output_shown = j->output.written;
+
+    return total;
+}
+
+void follow_job_output(job *j)
+{
+    int id = j->id;
+    sigset_t mask, previous;
+    struct timespec zero = { 0 };
+
+    //Mientras se sigue la salida, SIGINT se atiende a traves de un signalfd para detenerse en lugar de terminar el shell.
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigprocmask(SIG_BLOCK, &mask, &previous);
+
+    int interrupt_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    print_job_output(j, j->output_shown);
+
+    while (1)
+    {
+        struct pollfd fds[2] = {
+            { .fd = interrupt_fd, .events = POLLIN },
+            { .fd = sigchld_fd, .events = POLLIN }
+        };
+
+        if (poll_events(fds, 2, -1) < 0 && errno != EINTR)
+            break;
+
+        if (fds[0].revents & POLLIN)
+            break;
+
+        //Al terminar, reap_children imprime la salida pendiente y elimina el trabajo.
+        if (fds[1].revents & POLLIN)
+            reap_children();
+
+        if (get_job_by_id(id) != j)
+            break;
+
+        print_job_output(j, j->output_shown);
+    }
+
+    close(interrupt_fd);
+
+    //Se descarta una SIGINT pendiente antes de restaurar la mascara.
+    while (sigtimedwait(&mask, NULL, &zero) > 0);
+
+    sigprocmask(SIG_SETMASK, &previous, NULL);
+
+    output_puts("\n");
+}
+
+void update_process_status(process *p, int status, const struct rusage *usage)
+{
+    if (WIFEXITED(status) || WIFSIGNALED(status))
+    {
+        clock_gettime(CLOCK_MONOTONIC, &p->finished);
+        p->usage = *usage;
+    }
+
+    //Un hijo que no pudo ejecutar la ruta guardada invalida la entrada de la tabla de rutas.
+    if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_COMMAND_NOT_FOUND && p->path)
+        path_hash_remove(p->argv[0]);
+
+    p->wait_status = status;
+
+    if (WIFEXITED(status))
+        set_process_status(p, STATUS_DONE);
+    else if (WIFSIGNALED(status))
+        set_process_status(p, STATUS_TERMINATED);
+    else if (WIFSTOPPED(status))
+        set_process_status(p, STATUS_SUSPENDED);
+    else if (WIFCONTINUED(status))
+        set_process_status(p, STATUS_CONTINUED);
+}
+
+int wait_for_job(job *j)
+{
+    int status = 0;
+    size_t pn = 0;
+    uint64_t start = stats_now();
+
+    output_flush();
+
+    while (get_processes_count(j, PROC_FILTER_RUNNING) > 0)
+    {
+        struct pollfd fds[3] = { { .fd = sigchld_fd, .events = POLLIN } };
+        nfds_t nfds = 1;
+
+        if (j->err_fd[0] >= 0)
+            fds[nfds++] = (struct pollfd) { .fd = j->err_fd[0], .events = POLLIN };
+        if (j->io_fd[0] >= 0)
+            fds[nfds++] = (struct pollfd) { .fd = j->io_fd[0], .events = POLLIN };
+
+        //Se bloquea hasta que haya salida para reenviar o un cambio de estado en algun hijo.
+        if (poll_events(fds, nfds, -1) < 0)
+            continue;
+
+        if (nfds > 1)
+            pn += drain_job_pipes(j);
+
+        if (fds[0].revents & POLLIN)
+            reap_children();
+    }
+
+    //Lo que escribieron los procesos ya esta en los pipes y se lee hasta EAGAIN. No se espera EOF: un hijo que el trabajo
+    //dejo en segundo plano puede conservar los escritores indefinidamente, y remove_job cierra los pipes.
+    pn += drain_job_pipes(j);
+
+    if (pn)
+        output_puts("\n");
+
+    process *last_process = get_last_process(j);
+
+    if (last_process)
+        status = last_process->wait_status;
+
+    if (get_processes_count(j, PROC_FILTER_SUSPENDED) > 0)
+    {
+        print_job_status(j);
+        status = -1;
+    }
+
+    stats_record(STATS_WAIT, start);
+
+    return status;
+}
+
+int launch_job(job *j) 
+{
+    int status;
+    
+    insert_job(j);
+
+    //Un trabajo en segundo plano que excede el limite espera su turno sin crear procesos ni pipes. La cola se respeta aun con lugares libres.
+    if (j->mode == BACKGROUND_EXECUTION && background_max > 0 && (background_running >= background_max || job_queue_head))
+    {
+        enqueue_job(j);
+        print_job_process(j);
+        return 0;
+    }
+
+    status = start_job(j);
+
+    if (j->mode != BACKGROUND_EXECUTION) 
+    {
+        if (shell_terminal >= 0)
+            tcsetpgrp(shell_terminal, j->pgid);
+
+        status = wait_for_job(j);
+
+        if (j->timed && status >= 0)
+        {
+            job_usage u;
+
+            get_job_usage(j, &u);
+            print_usage(&u, 0);
+        }
+
+        if (shell_terminal >= 0)
+        {
+            signal(SIGTTOU, SIG_IGN);
+            tcsetpgrp(shell_terminal, getpid());
+            signal(SIGTTOU, SIG_DFL);
+        }
+
+        //Un trabajo suspendido pasa a segundo plano: al reanudarlo, reap_children recoge su salida y lo elimina al terminar.
+        if (status >= 0)
+            remove_job(j);
+        else
+            j->mode = BACKGROUND_EXECUTION;
+    }
+    else if (is_job_completed(j))
+        remove_job(j);
+    else
+        print_job_process(j);
+
+    return status;
+}
+
+static void inherit_background_policy(job_policy *policy)
+{
+    if (!policy->has_cpus && background_policy.has_cpus)
+    {
+        policy->cpus = background_policy.cpus;
+        policy->has_cpus = 1;
+    }
+    else if (!policy->has_cpus && background_policy.automatic)
+        policy_assign_cpu(policy);
+
+    if (!policy->has_nice && background_policy.has_nice)
+    {
+        policy->nice = background_policy.nice;
+        policy->has_nice = 1;
+    }
+
+    if (policy->io_class == IOPRIO_CLASS_NONE)
+    {
+        policy->io_class = background_policy.io_class;
+        policy->io_level = background_policy.io_level;
+    }
+}
+
+int start_job(job *j)
+{
+    int status = 0;
+
+    //La CPU automatica se asigna al lanzarse, por lo que un trabajo que espero en la cola recibe la siguiente libre en el turno.
+    if (j->mode == BACKGROUND_EXECUTION)
+        inherit_background_policy(&j->policy);
+
+    //Los flujos redirigidos a archivos no pasan por el shell: solo se crean los pipes de los que se reenvian.
+    int relay_out = get_last_process(j)->redirect[STDOUT_FILENO] == NULL;
+    int relay_err = 0;
+
+    for (process* p = j->first_process; p; p = p->next)
+        relay_err |= p->redirect[STDERR_FILENO] == NULL;
+
+    if ((relay_out && pipe2(j->io_fd, O_CLOEXEC) < 0) || (relay_err && pipe2(j->err_fd, O_CLOEXEC) < 0))
+    {
+        perror(KRED"\npipe\n"KDEF);
+        exit (EXIT_FAILURE);
+    }
+
+    //Solo el extremo de lectura es no bloqueante, los hijos escriben de forma bloqueante.
+    if (relay_out)
+        fcntl(j->io_fd[0], F_SETFL, fcntl(j->io_fd[0], F_GETFL) | O_NONBLOCK);
+    if (relay_err)
+        fcntl(j->err_fd[0], F_SETFL, fcntl(j->err_fd[0], F_GETFL) | O_NONBLOCK);
+
+    output_flush();
+
+    int in_fd = STDIN_FILENO;
+
+    for (process* p = j->first_process; p; p = p->next)
+    {
+        int stage_fd[2] = { -1, STDOUT_FILENO };
+
+        //Cada etapa de la pipeline escribe directamente en la siguiente, solo la ultima pasa por el shell.
+        if (p->next && pipe2(stage_fd, O_CLOEXEC) < 0)
+        {
+            perror(KRED"\npipe\n"KDEF);
+            status = -1;
+
+            for (; p; p = p->next)
+                set_process_status(p, STATUS_TERMINATED);
+
+            break;
+        }
+
+        if (launch_process(j, p, in_fd, p->next ? stage_fd[1] : j->io_fd[1]) < 0)
+            status = -1;
+
+        if (in_fd != STDIN_FILENO)
+            close(in_fd);
+        if (p->next)
+            close(stage_fd[1]);
+
+        in_fd = stage_fd[0];
+    }
+
+    if (in_fd != STDIN_FILENO && in_fd >= 0)
+        close(in_fd);
+
+    //El shell no escribe en los pipes, cerrar sus copias permite detectar el EOF.
+    if (j->io_fd[1] >= 0)
+        close(j->io_fd[1]);
+    if (j->err_fd[1] >= 0)
+        close(j->err_fd[1]);
+
+    j->io_fd[1] = j->err_fd[1] = -1;
+
+    //El trabajo ocupa un lugar del limite de trabajos en segundo plano hasta que se elimina de la tabla.
+    if (j->mode == BACKGROUND_EXECUTION)
+    {
+        j->slot = 1;
+        background_running++;
+    }
+
+    return status;
+}
+
+void enqueue_job(job *j)
+{
+    j->queued = 1;
+    j->next_queued = NULL;
+    set_job_status(j, STATUS_QUEUED);
+
+    if (job_queue_tail)
+        job_queue_tail->next_queued = j;
+    else
+        job_queue_head = j;
+
+    job_queue_tail = j;
+}
+
+job* dequeue_job(void)
+{
+    job *j = job_queue_head;
+
+    if (!j)
+        return NULL;
+
+    job_queue_head = j->next_queued;
+
+    if (!job_queue_head)
+        job_queue_tail = NULL;
+
+    j->queued = 0;
+    j->next_queued = NULL;
+
+    return j;
+}
+
+int dispatch_queued_jobs(void)
+{
+    int dispatched = 0;
+
+    while (job_queue_head && (background_max <= 0 || background_running < background_max))
+    {
+        job *j = dequeue_job();
+
+        set_job_status(j, STATUS_READY);
+        start_job(j);
+        dispatched++;
+
+        //Si ningun proceso se pudo lanzar el trabajo termina en el momento y libera su lugar.
+        if (is_job_completed(j))
+        {
+            print_job_status(j);
+            remove_job(j);
+        }
+    }
+
+    return dispatched;
+}
+
+void cancel_queued_job(job *j)
+{
+    job **link = &job_queue_head;
+
+    while (*link && *link != j)
+        link = &(*link)->next_queued;
+
+    if (!*link)
+        return;
+
+    *link = j->next_queued;
+
+    if (job_queue_tail == j)
+    {
+        job_queue_tail = NULL;
+
+        for (job *q = job_queue_head; q; q = q->next_queued)
+            job_queue_tail = q;
+    }
+
+    j->queued = 0;
+    set_job_status(j, STATUS_TERMINATED);
+    print_job_status(j);
+    remove_job(j);
+}
+
+void set_background_max(int max)
+{
+    background_max = max > 0 ? max : 0;
+
+    dispatch_queued_jobs();
+}
+
+int launch_process(job *j, process *p, int in_fd, int out_fd) 
+{
+    p->status = STATUS_RUNNING;
+    clock_gettime(CLOCK_MONOTONIC, &p->started);
+    p->finished = p->started;
+
+    //Los comandos sin '/' se resuelven una unica vez en el shell en lugar de recorrer PATH en cada hijo.
+    if (!strchr(p->argv[0], '/'))
+    {
+        uint64_t lookup = stats_now();
+
+        p->path = path_hash_lookup(p->argv[0]);
+        stats_record(STATS_PATH_LOOKUP, lookup);
+
+        if (!p->path)
+        {
+            output_error(KRED"\nCommand not found!\n\n"KDEF);
+            set_process_status(p, STATUS_TERMINATED);
+            p->wait_status = W_EXITCODE(EXIT_COMMAND_NOT_FOUND, 0);
+            return -1;
+        }
+    }
+    else
+        p->path = NULL;
+
+    uint64_t start = stats_now();
+    int result;
+
+    if (launch_backend == LAUNCH_SPAWN)
+        result = spawn_process(j, p, in_fd, out_fd);
+    else if (launch_backend == LAUNCH_ZYGOTE)
+        result = zygote_process(j, p, in_fd, out_fd);
+    else
+        result = fork_process(j, p, in_fd, out_fd);
+
+    stats_record(STATS_LAUNCH, start);
+
+    //Un proceso que no se pudo lanzar termina con el mismo estado que tendria si hubiera fallado en el hijo.
+    if (result < 0)
+    {
+        set_process_status(p, STATUS_TERMINATED);
+
+        if (p->wait_status == 0)
+            p->wait_status = W_EXITCODE(EXIT_FAILURE, 0);
+
+        return -1;
+    }
+
+    if (j->pgid <= 0)
+        j->pgid = p->pid;
+
+    setpgid(p->pid, j->pgid);
+    pid_index_insert(p);
+
+    return 0;
+}
+
+int fork_process(job *j, process *p, int in_fd, int out_fd) 
+{
+    pid_t childpid = fork();
+
+    if (childpid < 0)
+        return -1;
+    else if (childpid == 0)
+    {
+        sigset_t mask;
+
+        signal(SIGINT, SIG_DFL);
+        signal(SIGQUIT, SIG_DFL);
+        signal(SIGTSTP, SIG_DFL);
+        signal(SIGTTIN, SIG_DFL);
+        signal(SIGTTOU, SIG_DFL);
+        signal(SIGCHLD, SIG_DFL);
+
+        sigemptyset(&mask);
+        sigprocmask(SIG_SETMASK, &mask, NULL);
+
+        p->pid = getpid();
+        if (j->pgid <= 0)
+            j->pgid = p->pid;
+
+        setpgid(0, j->pgid);
+
+        if (in_fd != STDIN_FILENO)
+            dup2(in_fd, STDIN_FILENO);
+        if (out_fd >= 0)
+            dup2(out_fd, STDOUT_FILENO);
+        if (j->err_fd[1] >= 0)
+            dup2(j->err_fd[1], STDERR_FILENO);
+
+        //Las redirecciones se abren en el hijo, por lo que escribir en un archivo no consume tiempo del shell.
+        if (open_redirections(p) < 0)
+            _exit(EXIT_FAILURE);
+
+        apply_policy(&j->policy, 0);
+
+        //Si la ruta guardada dejo de ser valida se reintenta con la busqueda normal en PATH.
+        if (p->path)
+            execv(p->path, p->argv);
+
+        execvp(p->argv[0], p->argv);
+
+        //_exit evita que el hijo vacie o reposicione los streams de stdio compartidos con el shell.
+        fprintf(stderr, "Command not found!\n");
+        _exit(EXIT_COMMAND_NOT_FOUND);
+    } 
+
+    p->pid = childpid;
+
+    return 0;
+}
+
+int spawn_process(job *j, process *p, int in_fd, int out_fd)
+{
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_t actions;
+    sigset_t default_signals, empty_mask;
+    int error;
+
+    //posix_spawn no permite fijar la politica antes de exec. Salvo la CPU asignada de forma automatica, que se puede cambiar
+    //con el proceso ya en ejecucion, los trabajos con politica propia se lanzan con fork.
+    if (j->policy.has_nice || j->policy.io_class != IOPRIO_CLASS_NONE || (j->policy.has_cpus && !j->policy.automatic))
+        return fork_process(j, p, in_fd, out_fd);
+
+    sigemptyset(&empty_mask);
+    sigemptyset(&default_signals);
+    sigaddset(&default_signals, SIGINT);
+    sigaddset(&default_signals, SIGQUIT);
+    sigaddset(&default_signals, SIGTSTP);
+    sigaddset(&default_signals, SIGTTIN);
+    sigaddset(&default_signals, SIGTTOU);
+    sigaddset(&default_signals, SIGCHLD);
+
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+    posix_spawnattr_setpgroup(&attr, j->pgid > 0 ? j->pgid : 0);
+    posix_spawnattr_setsigdefault(&attr, &default_signals);
+    posix_spawnattr_setsigmask(&attr, &empty_mask);
+
+    posix_spawn_file_actions_init(&actions);
+
+    if (in_fd != STDIN_FILENO)
+        posix_spawn_file_actions_adddup2(&actions, in_fd, STDIN_FILENO);
+    if (out_fd >= 0)
+        posix_spawn_file_actions_adddup2(&actions, out_fd, STDOUT_FILENO);
+    if (j->err_fd[1] >= 0)
+        posix_spawn_file_actions_adddup2(&actions, j->err_fd[1], STDERR_FILENO);
+
+    for (int fd = 0; fd < STANDARD_STREAMS; fd++)
+        if (p->redirect[fd])
+            posix_spawn_file_actions_addopen(&actions, fd, p->redirect[fd], p->redirect_flags[fd], REDIRECT_FILE_MODE);
+
+    error = posix_spawn(&p->pid, p->path ? p->path : p->argv[0], &actions, &attr, p->argv, environ);
+
+    //Si la ruta guardada dejo de ser valida se descarta y se vuelve a resolver el comando.
+    //El error tambien puede provenir de abrir una redireccion, en cuyo caso la ruta sigue siendo valida.
+    if (error && p->path && access(p->path, X_OK) < 0)
+    {
+        path_hash_remove(p->argv[0]);
+        p->path = NULL;
+        error = posix_spawnp(&p->pid, p->argv[0], &actions, &attr, p->argv, environ);
+    }
+
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+
+    //La CPU asignada de forma automatica se fija desde el shell apenas se crea el proceso.
+    if (!error && j->policy.has_cpus)
+        apply_policy(&j->policy, p->pid);
+
+    if (error)
+    {
+        int redirected = p->redirect[STDIN_FILENO] || p->redirect[STDOUT_FILENO] || p->redirect[STDERR_FILENO];
+
+        //posix_spawn informa con el mismo codigo un comando inexistente y una redireccion que no se pudo abrir.
+        if (redirected && access(p->path ? p->path : p->argv[0], X_OK) == 0)
+        {
+            output_error(KRED"\nRedirection failed: %s\n\n"KDEF, strerror(error));
+            p->wait_status = W_EXITCODE(EXIT_FAILURE, 0);
+        }
+        else
+        {
+            output_error(KRED"\nCommand not found!\n\n"KDEF);
+            p->wait_status = W_EXITCODE(EXIT_COMMAND_NOT_FOUND, 0);
+        }
+
+        return -1;
+    }
+
+    return 0;
+}
+
+int zygote_process(job *j, process *p, int in_fd, int out_fd)
+{
+    int fds[ZYGOTE_FDS] = { in_fd, out_fd, j->err_fd[1] };
+    pid_t pid = zygote_launch(p->path, p->argv, p->argc, j->pgid, fds, p->redirect, p->redirect_flags, &j->policy);
+
+    if (pid == ZYGOTE_UNAVAILABLE)
+        return spawn_process(j, p, in_fd, out_fd);
+
+    if (pid < 0)
+        return -1;
+
+    p->pid = pid;
+
+    return 0;
+}
+
+void set_launch_backend(const char* name)
+{
+    if (name == NULL)
+        return;
+
+    if (!strcmp(name, "fork"))
+        launch_backend = LAUNCH_FORK;
+    else if (!strcmp(name, "spawn"))
+        launch_backend = LAUNCH_SPAWN;
+    else if (!strcmp(name, "zygote"))
+        launch_backend = LAUNCH_ZYGOTE;
+}
+
+void print_job_all_status(void) 
+{
+    output_puts("\n");
+
+    for (int id = 1; id <= job_table_max; id++)
+        if (job_table[id])
+            print_job_status(job_table[id]);
+
+    output_puts("\n");
+}
+
+void print_job_all_usage(void)
+{
+    output_puts("\n");
+
+    for (int id = 1; id <= job_table_max; id++)
+    {
+        job *j = job_table[id];
+
+        if (!j)
+            continue;
+
+        char policy[POLICY_STRING_SIZE];
+
+        format_policy(&j->policy, policy, sizeof(policy));
+        output_printf(KBLU"[%d]"KDEF, j->id);
+
+        if (*policy)
+            output_printf(" (%s)\n   ", policy);
+
+        for (process* p = j->first_process; p; p = p->next)
+        {
+            job_usage u;
+
+            get_process_usage(p, &u);
+
+            if (p->pid > 0)
+                output_printf(KBLU" %d %s %s"KDEF, p->pid, PROCESS_STATUS_STRING[p->status], p->argv[0]);
+            else
+                output_printf(KBLU" %s %s"KDEF, PROCESS_STATUS_STRING[p->status], p->argv[0]);
+
+            //Los tiempos de CPU y la memoria solo se conocen cuando el proceso termino.
+            if (p->pid <= 0)
+                output_puts("\n");
+            else if (p->status == STATUS_DONE || p->status == STATUS_TERMINATED)
+                output_printf("  real %.3fs user %.3fs sys %.3fs maxrss %ld KB csw %ld/%ld\n",
+                              u.real, u.user, u.sys, u.maxrss, u.nvcsw, u.nivcsw);
+            else
+                output_printf("  real %.3fs\n", u.real);
+
+            if (p->next)
+                output_puts("   ");
+        }
+    }
+
+    output_puts("\n");
+}
+
+void print_usage(const job_usage *u, int id)
+{
+    output_puts("\n"KBLU);
+
+    if (id > 0)
+        output_printf("[%d]\n", id);
+
+    output_printf("real\t%.3fs\nuser\t%.3fs\nsys\t%.3fs\nmaxrss\t%ld KB\ncsw\t%ld voluntary, %ld involuntary\n",
+                  u->real, u->user, u->sys, u->maxrss, u->nvcsw, u->nivcsw);
+    output_puts(KDEF"\n");
+}
 
 void print_job_status(job *j) 
 {
-    fprintf(stdout, KBLU"[%d]"KDEF, j->id);
+    output_printf(KBLU"[%d]"KDEF, j->id);
 
     for (process* p = j->first_process; p; p = p->next) {
-        fprintf(stdout, KBLU" %d %s %s"KDEF, p->pid, PROCESS_STATUS_STRING[p->status], p->argv[0]);
+        //Los procesos de un trabajo en espera aun no tienen PID.
+        if (p->pid > 0)
+            output_printf(KBLU" %d %s %s"KDEF, p->pid, PROCESS_STATUS_STRING[p->status], p->argv[0]);
+        else
+            output_printf(KBLU" %s %s"KDEF, PROCESS_STATUS_STRING[p->status], p->argv[0]);
 
         if (p->next)
-            fprintf(stdout, KBLU"|\n"KDEF);
+            output_puts(KBLU"|\n"KDEF);
         else
-            fprintf(stdout, "\n");
+            output_puts("\n");
     }
 }
 
 void print_job_process(job *j) 
 {
-    fprintf(stdout, KBLU"\n[%d]"KDEF, j->id);
+    output_printf(KBLU"\n[%d]"KDEF, j->id);
 
     for (process* p = j->first_process; p; p = p->next)
-        fprintf(stdout, KBLU" %d %s"KDEF, p->pid, p->argv[0]);
+        if (p->pid > 0)
+            output_printf(KBLU" %d %s"KDEF, p->pid, p->argv[0]);
+        else
+            output_printf(KBLU" %s %s"KDEF, PROCESS_STATUS_STRING[p->status], p->argv[0]);
 
-    fprintf(stdout, "\n\n");
+    output_puts("\n\n");
 }
 
-void print_job_pipe(job *j)
+size_t drain_job_pipes(job *j)
 {
-    close(j->io_fd[1]);
-    close(j->err_fd[1]);
+    int colored = isatty(STDOUT_FILENO);
+    size_t pn = 0;
+    uint64_t start = stats_now();
+    int eof;
+
+    if (j->err_fd[0] >= 0)
+    {
+        pn += relay_pipe(j->err_fd[0], STDOUT_FILENO, colored ? KRED : NULL, &eof);
 
-    fcntl(j->io_fd[0], F_SETFL, fcntl(j->io_fd[0], F_GETFL) | O_NONBLOCK);
-    fcntl(j->err_fd[0], F_SETFL, fcntl(j->err_fd[0], F_GETFL) | O_NONBLOCK);
+        if (eof)
+        {
+            close(j->err_fd[0]);
+            j->err_fd[0] = -1;
+        }
+    }
 
-    char c; int pn = 0;
-    while (read(j->err_fd[0], &c, sizeof(c)) > 0)
+    if (j->io_fd[0] >= 0)
     {
-        fprintf(stdout, KRED"%c"KDEF, c);
-        pn = 1;
-    }    
+        pn += relay_pipe(j->io_fd[0], STDOUT_FILENO, colored ? KYEL : NULL, &eof);
+
+        if (eof)
+        {
+            close(j->io_fd[0]);
+            j->io_fd[0] = -1;
+        }
+    }
+
+    //Solo se registran los reenvios efectivos: las consultas sin datos no representan salida drenada.
+    if (pn)
+        stats_record(STATS_DRAIN, start);
+
+    return pn;
+}
+
+//Indica, sin bloquearse, si una lectura sobre el descriptor devolveria datos o el fin.
+static int is_readable(int fd)
+{
+    struct pollfd p = { .fd = fd, .events = POLLIN };
+
+    return poll(&p, 1, 0) > 0;
+}
+
+static void wait_writable(int fd)
+{
+    struct pollfd p = { .fd = fd, .events = POLLOUT };
 
-    while (read(j->io_fd[0], &c, sizeof(c)) > 0)
+    while (poll(&p, 1, -1) < 0 && errno == EINTR);
+}
+
+size_t relay_pipe(int fd, int out_fd, const char* color, int* eof)
+{
+    static char buffer[RELAY_BUFFER_SIZE];
+    size_t total = 0;
+    ssize_t n;
+
+    *eof = 0;
+
+    //Sin color no hace falta pasar los datos por el espacio de usuario.
+    if (!color)
     {
-        fprintf(stdout, KYEL"%c"KDEF, c);
-        pn = 1;
+        while (1)
+        {
+            while ((n = splice(fd, NULL, out_fd, NULL, RELAY_BUFFER_SIZE, SPLICE_F_MOVE | SPLICE_F_NONBLOCK)) > 0)
+                total += n;
+
+            //EAGAIN tambien se produce con la salida llena: si aun hay datos para leer se espera a poder escribir y se reintenta.
+            if (n < 0 && errno == EAGAIN && is_readable(fd))
+            {
+                wait_writable(out_fd);
+                continue;
+            }
+
+            if (n < 0 && errno == EINTR)
+                continue;
+
+            break;
+        }
+
+        if (n == 0 || errno != EINVAL)
+        {
+            *eof = (n == 0);
+            return total;
+        }
     }
 
-    if(pn)
-        fprintf(stdout, "\n");
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        if (color)
+        {
+            //Un unico par de codigos de color por cada bloque leido.
+            struct iovec iov[] = {
+                { .iov_base = (void*) color, .iov_len = strlen(color) },
+                { .iov_base = buffer, .iov_len = n },
+                { .iov_base = KDEF, .iov_len = strlen(KDEF) }
+            };
+
+            write_all_iov(out_fd, iov, 3);
+        }
+        else
+        {
+            struct iovec iov = { .iov_base = buffer, .iov_len = n };
 
-    close(j->io_fd[0]);
-    close(j->err_fd[0]);
+            write_all_iov(out_fd, &iov, 1);
+        }
+
+        total += n;
+    }
+
+    *eof = (n == 0);
+
+    return total;
 }
 
-char** str_to_array(char* str, u_int8_t* n)
+void write_all_iov(int fd, struct iovec* iov, int iovcnt)
 {
-    char** argv = malloc(sizeof(char*));
+    while (iovcnt > 0)
+    {
+        ssize_t n = writev(fd, iov, iovcnt);
 
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            //La salida puede ser no bloqueante (por ejemplo, un pipe compartido): se espera a que el lector avance.
+            if (errno == EAGAIN)
+            {
+                wait_writable(fd);
+                continue;
+            }
+
+            return;
+        }
+
+        while (iovcnt > 0 && (size_t) n >= iov->iov_len)
+        {
+            n -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+
+        if (iovcnt > 0)
+        {
+            iov->iov_base = (char*) iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+}
+
+void get_process_usage(process *p, job_usage *u)
+{
+    struct timespec now;
+    int finished = p->status == STATUS_DONE || p->status == STATUS_TERMINATED;
+
+    if (!finished)
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+    u->real = elapsed_seconds(&p->started, finished ? &p->finished : &now);
+    u->user = p->usage.ru_utime.tv_sec + p->usage.ru_utime.tv_usec / 1e6;
+    u->sys = p->usage.ru_stime.tv_sec + p->usage.ru_stime.tv_usec / 1e6;
+    u->maxrss = p->usage.ru_maxrss;
+    u->nvcsw = p->usage.ru_nvcsw;
+    u->nivcsw = p->usage.ru_nivcsw;
+}
+
+void get_job_usage(job *j, job_usage *u)
+{
+    memset(u, 0, sizeof(job_usage));
+
+    for (process* p = j->first_process; p; p = p->next)
+    {
+        job_usage pu;
+
+        get_process_usage(p, &pu);
+
+        //Las etapas de una pipeline corren en paralelo: el tiempo real del trabajo es el de la mas larga, no la suma.
+        if (pu.real > u->real)
+            u->real = pu.real;
+
+        u->user += pu.user;
+        u->sys += pu.sys;
+        u->nvcsw += pu.nvcsw;
+        u->nivcsw += pu.nivcsw;
+
+        if (pu.maxrss > u->maxrss)
+            u->maxrss = pu.maxrss;
+    }
+}
+
+double elapsed_seconds(const struct timespec *from, const struct timespec *to)
+{
+    return (to->tv_sec - from->tv_sec) + (to->tv_nsec - from->tv_nsec) / 1e9;
+}
+
+char** str_to_array(arena* a, char* str, int* n)
+{
     *n = 0;
-    
-    char* token = strtok(str, " ");
-    while (token != NULL)
+
+    //Primera pasada: cuenta los tokens para reservar el array de una sola vez.
+    for (char* c = str; *c; )
     {
-        argv[*n] = malloc(sizeof(char) * strlen(token));
-        strcpy(argv[(*n)++], token);
-        argv = realloc(argv, sizeof(char*) * (*n + 1));
-        token = strtok(NULL, " ");
+        while (*c == ' ')
+            c++;
+
+        if (*c)
+            (*n)++;
+
+        while (*c && *c != ' ')
+            c++;
     }
 
-    argv[*n] = NULL;
+    char** argv = arena_alloc(a, sizeof(char*) * (*n + 1));
+    char* copy = arena_strdup(a, str);
+    char* save;
+    int i = 0;
+
+    for (char* token = strtok_r(copy, " ", &save); token; token = strtok_r(NULL, " ", &save))
+        argv[i++] = token;
+
+    argv[i] = NULL;
 
     return argv;
 }
 
 void free_job(job *j)
 {
-    process *tmp;
-    process *p = j->first_process;
-
-    while(p)
+    for (int i = 0; i < 2; i++)
     {
-        free_array(p->argv, p->argc);
-        tmp = p;
-        p = p->next;
-        free(tmp);
+        if (j->io_fd[i] >= 0)
+            close(j->io_fd[i]);
+        if (j->err_fd[i] >= 0)
+            close(j->err_fd[i]);
     }
-    
-    free(j);
-}
 
-void free_array(char** array, u_int8_t n)
-{
-    for (u_int8_t i = 0; i < n; i++)
-        free(array[i]);
-    
-    free(array);
-}
\ No newline at end of file
+    arena_destroy(j->arena);
+}
@@ -0,0 +1,158 @@
+/**
+ * @file LineReader.c
+ * @author Bottini, Franco Nicolas
+ * @brief Implementacion del lector de lineas.
+ * @version 1.2
+ * @date Septiembre de 2022
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/LineReader.h"
+
+//Copia una linea del mapeo al buffer del lector, que solo crece cuando aparece una linea mas larga que las anteriores.
+static char* copy_line(line_reader *r, const char *start, size_t len)
+{
+    if (len + 1 > r->line_capacity)
+    {
+        r->line_capacity = len + 1;
+        r->line = realloc(r->line, r->line_capacity);
+    }
+
+    memcpy(r->line, start, len);
+    r->line[len] = '\0';
+
+    return r->line;
+}
+
+line_reader* line_reader_open(int fd, int interactive)
+{
+    line_reader *r = malloc(sizeof(line_reader));
+    struct stat st;
+
+    r->fd = fd;
+    r->interactive = interactive;
+    r->start = 0;
+    r->end = 0;
+    r->eof = 0;
+    r->mapped = 0;
+    r->line = NULL;
+    r->line_capacity = 0;
+
+    if (!interactive && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (map != MAP_FAILED)
+        {
+            madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+            r->buffer = map;
+            r->capacity = r->end = st.st_size;
+            r->eof = 1;
+            r->mapped = 1;
+
+            return r;
+        }
+    }
+
+    r->capacity = LINE_READER_CHUNK_SIZE;
+    r->buffer = malloc(r->capacity);
+
+    return r;
+}
+
+ssize_t line_reader_next(line_reader *r, char **line)
+{
+    size_t scanned = r->start;
+
+    while (1)
+    {
+        //memchr de glibc recorre el buffer con instrucciones vectoriales.
+        char *newline = memchr(r->buffer + scanned, '\n', r->end - scanned);
+
+        if (newline)
+        {
+            size_t len = newline - (r->buffer + r->start);
+
+            //El mapeo es de solo lectura: la linea se copia en lugar de terminarla en el lugar.
+            if (r->mapped)
+                *line = copy_line(r, r->buffer + r->start, len);
+            else
+            {
+                *newline = '\0';
+                *line = r->buffer + r->start;
+            }
+
+            r->start = newline - r->buffer + 1;
+
+            return len;
+        }
+
+        if (r->eof)
+        {
+            if (r->start == r->end)
+                return -1;
+
+            size_t len = r->end - r->start;
+
+            //Ultima linea sin salto de linea: el buffer dinamico siempre deja lugar para el fin de cadena.
+            if (r->mapped)
+                *line = copy_line(r, r->buffer + r->start, len);
+            else
+            {
+                r->buffer[r->end] = '\0';
+                *line = r->buffer + r->start;
+            }
+
+            r->start = r->end;
+
+            return len;
+        }
+
+        //Mueve la linea incompleta al comienzo del buffer y solo lo agranda si aun asi no hay lugar.
+        if (r->start > 0)
+        {
+            memmove(r->buffer, r->buffer + r->start, r->end - r->start);
+            r->end -= r->start;
+            r->start = 0;
+        }
+
+        if (r->capacity - r->end <= LINE_READER_CHUNK_SIZE / 2)
+        {
+            r->capacity *= 2;
+            r->buffer = realloc(r->buffer, r->capacity);
+        }
+
+        scanned = r->end;
+
+        ssize_t n = read(r->fd, r->buffer + r->end, r->capacity - r->end - 1);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n <= 0)
+            r->eof = 1;
+        else
+            r->end += n;
+    }
+}
+
+int line_reader_pending(line_reader *r)
+{
+    return r->start < r->end && memchr(r->buffer + r->start, '\n', r->end - r->start) != NULL;
+}
+
+void line_reader_close(line_reader *r)
+{
+    close(r->fd);
+
+    if (r->mapped)
+        munmap(r->buffer, r->capacity);
+    else
+        free(r->buffer);
+
+    free(r->line);
+    free(r);
+}
@@ -10,108 +10,443 @@
  */
 
 #include "../inc/MyShell.h"
+#include "BuiltinsTable.h"
+
+/** Tabla de comandos internos, indexada por su identificador **/
+static const builtin BUILTINS[CMM_BUILTINS_COUNT] = {
+#define BUILTIN(id, name, handler, kind) [id] = { name, sizeof(name) - 1, handler, kind },
+#include "../inc/Builtins.def"
+#undef BUILTIN
+};
+
+int last_exit_status = EXIT_SUCCESS;
+int batch_wait_timeout = -1;
+int batch_kill_on_timeout = 0;
+int batch_max_workers = 0;
+int batch_dump_stats = 0;
 
 int main(int argc, char* argv[])
 {
-    myshell_validate_execution(argc);
+    myshell_validate_execution(argc, argv);
     job_control_init();
-    myshell_loop(command_source(argc, argv));
+    atexit(output_flush);
+
+    //Sin una terminal que mostrar linea a linea, la salida de los comandos internos se acumula y se emite por bloques.
+    output_set_block_buffered(!isatty(STDOUT_FILENO));
+
+    if (argc - optind > 1 || batch_max_workers > 0)
+        exit(myshell_run_scripts(argc - optind, argv + optind, batch_max_workers > 0 ? batch_max_workers : 1));
+
+    if (argc - optind == 1)
+        myshell_run_batch(argv[optind]);
+
+    myshell_loop(command_source(argc - optind + 1, argv + optind - 1));
 
     return EXIT_SUCCESS;
 }
 
-void myshell_validate_execution(int argc)
+void myshell_validate_execution(int argc, char* argv[])
 {
-    if(argc > 2)
+    int opt;
+
+    while((opt = getopt(argc, argv, "t:kj:s")) != -1)
+    {
+        switch (opt)
+        {
+            case 't':
+                batch_wait_timeout = atoi(optarg);
+                break;
+
+            case 'k':
+                batch_kill_on_timeout = 1;
+                break;
+
+            case 's':
+                batch_dump_stats = 1;
+                break;
+
+            case 'j':
+                batch_max_workers = atoi(optarg);
+
+                if(batch_max_workers > 0)
+                    break;
+
+                /* fall through */
+            default:
+                myshell_print_usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if((batch_max_workers > 0 || batch_dump_stats) && argc - optind < 1)
     {
-        fprintf(stderr, KRED"\nOnly one input argument is allowed !\n"KDEF);
-        fprintf(stderr, KBLU"Input argument: batchfile.\n\n"KDEF);
+        output_error(KRED"\nAt least one batchfile is required with -j or -s !\n"KDEF);
+        myshell_print_usage();
         exit(EXIT_FAILURE);
     }
 }
 
-void myshell_loop(FILE* input_source)
+void myshell_print_usage(void)
+{
+    fprintf(stderr, KBLU"Input arguments: [-t seconds [-k]] [-j N] [-s] batchfile...\n"KDEF);
+    fprintf(stderr, KBLU"  -t seconds  Maximum time to wait for background jobs at the end of the batchfile.\n"KDEF);
+    fprintf(stderr, KBLU"  -k          Kill the jobs still running when the wait time expires.\n"KDEF);
+    fprintf(stderr, KBLU"  -j N        Run up to N batchfiles concurrently, tagging their output.\n"KDEF);
+    fprintf(stderr, KBLU"  -s          Print the latency histograms of each batchfile when it exits.\n\n"KDEF);
+}
+
+void myshell_wait_jobs(void)
+{
+    int remaining = wait_for_all_jobs(batch_wait_timeout < 0 ? -1 : batch_wait_timeout * 1000);
+
+    if(remaining == 0)
+        return;
+
+    output_error(KRED"\n%d job(s) still running after %d seconds !\n"KDEF, remaining, batch_wait_timeout);
+    print_job_all_status();
+
+    if(batch_kill_on_timeout)
+    {
+        kill_all_jobs(SIGTERM);
+        wait_for_all_jobs(-1);
+    }
+}
+
+void myshell_loop(line_reader* input_source)
 {
-    char input_buffer[MAX_LEN_INPUT];
+    char* input;
 
     while (1)
     {
-        if(input_source == stdin)
+        if(input_source->interactive)
+        {
             print_prompt();
+
+            //Mientras se espera la entrada se informan los trabajos en segundo plano que cambien de estado.
+            if(!line_reader_pending(input_source))
+                while(wait_for_input(input_source->fd) > 0)
+                    print_prompt();
+        }
+        else if(get_jobs_count() > 0)
+            reap_children();
         
-        READ_INPUT_RESULT read_result = get_input(input_buffer, MAX_LEN_INPUT, input_source);
+        READ_INPUT_RESULT read_result = get_input(input_source, &input);
 
         if (read_result == INP_READ)
         {
-            if(input_source != stdin)
-                fprintf(stdout, "> %s\n", input_buffer);
+            if(!input_source->interactive)
+                output_printf("> %s\n", input);
+
+            execute_input(input);
+        }
+        else if (read_result == INP_END)
+        {
+            int interactive = input_source->interactive;
 
-            execute_input(input_buffer);
+            line_reader_close(input_source);
+
+            if(!interactive)
+                myshell_wait_jobs();
+
+            exit(EXIT_SUCCESS);
         }
+    }  
+}
+
+void myshell_run_batch(const char* path)
+{
+    struct stat st;
+
+    //Se registra luego de output_flush, por lo que se ejecuta antes y las estadisticas se emiten con el resto de la salida.
+    if (batch_dump_stats)
+        atexit(print_stats);
+
+    //Un FIFO o una sustitucion de procesos no se puede compilar de antemano: sus lineas se ejecutan a medida que llegan.
+    if (stat(path, &st) == 0 && !S_ISREG(st.st_mode))
+        myshell_loop(open_batch_file(path));
+
+    script_cache* script = compile_batch_file(path);
+    script_line line;
+
+    while (script_cache_next(script, &line))
+    {
+        //Sin trabajos no hay cambios de estado que informar: se evitan las llamadas al sistema en cada linea.
+        if (get_jobs_count() > 0)
+            reap_children();
+
+        output_printf("> %s\n", line.text);
+
+        if (line.command != CMM_EXTERN)
+            command_interprete(line.command, line.args);
         else
+            execute_compiled_extern(&line);
+    }
+
+    myshell_wait_jobs();
+    script_cache_close(script);
+
+    exit(EXIT_SUCCESS);
+}
+
+script_cache* compile_batch_file(const char* path)
+{
+    script_cache* script = script_cache_open(path, builtins_signature());
+
+    if (script == NULL)
+    {
+        output_error(KRED"\n%s: %s\n\n"KDEF, path, strerror(errno));  
+        exit(EXIT_FAILURE);
+    }
+
+    if (script->loaded)
+        return script;
+
+    line_reader* reader = open_batch_file(path);
+    READ_INPUT_RESULT read_result;
+    char* input;
+
+    while ((read_result = get_input(reader, &input)) != INP_END)
+    {
+        if (read_result != INP_READ)
+            continue;
+
+        uint64_t start = stats_now();
+        char* args;
+        COMMANDS_FLAGS flag = classify_input(input, &args);
+
+        if (flag != CMM_EXTERN)
+            script_cache_add_builtin(script, input, flag, args);
+        else
+            script_cache_add_extern(script, input);
+
+        stats_record(STATS_PARSE, start);
+    }
+
+    line_reader_close(reader);
+
+    //Si no se puede guardar (por ejemplo, un directorio sin permisos de escritura) el batchfile se ejecuta igual desde memoria.
+    script_cache_save(script);
+
+    return script;
+}
+
+uint64_t builtins_signature(void)
+{
+    uint64_t hash = 14695981039346656037ULL;
+
+    //Los identificadores guardados en un batchfile compilado dependen del orden de la tabla de comandos internos.
+    for (size_t i = 0; i < CMM_BUILTINS_COUNT; i++)
+        for (const char* c = BUILTINS[i].name; ; c++)
         {
-            if(input_source != stdin)
-            {
-                if(read_result != INP_EMPTY_LINE)
-                {
-                    fclose(input_source);
+            hash = (hash ^ (unsigned char) *c) * 1099511628211ULL;
 
-                    if(read_result == INP_END)
-                    {
-                        while(first_job);
-                        exit(EXIT_SUCCESS);
-                    }
-                        
-                    if(read_result == INP_TO_LONG)
-                        exit(EXIT_FAILURE);
-                }
-            }
+            if (*c == ASCII_END_OF_STRING)
+                break;
         }
 
-    }  
+    return hash;
 }
 
 void print_prompt(void)
 {
-    fprintf(stdout, KGRN"%s@%s~$ "KDEF, getenv("USER"), getenv("PWD"));
+    output_printf(KGRN"%s@%s~$ "KDEF, getenv("USER"), getenv("PWD"));
+    output_flush();
 }
 
-FILE* command_source(int argc, char* argv[])
+line_reader* command_source(int argc, char* argv[])
 {
-    FILE* fp;
-
     if (argc == 2)
-    {
-        fp = fopen(argv[1], "r");
+        return open_batch_file(argv[1]);
+
+    //La entrada estandar solo es interactiva si es una terminal. Un pipe o un archivo redirigido se procesan como un batchfile.
+    return line_reader_open(STDIN_FILENO, isatty(STDIN_FILENO));
+}
+
+line_reader* open_batch_file(const char* path)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
   	    
-        if(fp == NULL)
+    if(fd < 0)
+    {
+        output_error(KRED"\n%s: %s\n\n"KDEF, path, strerror(errno));  
+        exit(EXIT_FAILURE);
+    }
+
+    return line_reader_open(fd, 0);
+}
+
+int myshell_run_scripts(int count, char* scripts[], int max_workers)
+{
+    script_worker* workers = calloc(count, sizeof(script_worker));
+    int next = 0, running = 0, failed = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        workers[i].name = scripts[i];
+        workers[i].pid = -1;
+        workers[i].out_fd = -1;
+    }
+
+    while (next < count || running > 0)
+    {
+        while (running < max_workers && next < count)
+            if (start_script_worker(workers, count, next++) == 0)
+                running++;
+            else
+                failed = 1;
+
+        struct pollfd fds[running + 1];
+        int index[running + 1];
+        nfds_t nfds = 0;
+
+        fds[nfds++] = (struct pollfd) { .fd = sigchld_fd, .events = POLLIN };
+
+        for (int i = 0; i < next; i++)
+            if (workers[i].out_fd >= 0)
+            {
+                index[nfds] = i;
+                fds[nfds++] = (struct pollfd) { .fd = workers[i].out_fd, .events = POLLIN };
+            }
+
+        if (poll(fds, nfds, -1) < 0)
+            continue;
+
+        for (nfds_t k = 1; k < nfds; k++)
+            if (fds[k].revents)
+                relay_script_output(&workers[index[k]]);
+
+        if (fds[0].revents & POLLIN)
         {
-            fprintf(stderr, KRED"\n%s\n\n"KDEF, strerror(errno));  
-            exit(EXIT_FAILURE);
+            struct signalfd_siginfo info[16];
+            int status;
+            pid_t pid;
+
+            while (read(sigchld_fd, info, sizeof(info)) > 0);
+
+            while ((pid = waitpid(WAIT_ANY, &status, WNOHANG)) > 0)
+                for (int i = 0; i < next; i++)
+                    if (workers[i].pid == pid)
+                    {
+                        workers[i].pid = -1;
+                        failed |= !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS;
+                    }
         }
+
+        //Un script termina cuando su proceso finalizo y ya se reenvio toda su salida.
+        running = 0;
+
+        for (int i = 0; i < next; i++)
+            if (workers[i].pid > 0 || workers[i].out_fd >= 0)
+                running++;
     }
-    else
-        fp = stdin;
 
-    return fp;
+    for (int i = 0; i < count; i++)
+        free(workers[i].pending);
+
+    free(workers);
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
-READ_INPUT_RESULT get_input(char* buffer, int buffer_size, FILE* fp)
+int start_script_worker(script_worker* workers, int count, int i)
 {
-    if(fgets(buffer, buffer_size + 1, fp) == NULL)
-        return INP_END;
-    
-    char* endOfBuffer = buffer + strlen(buffer) - 1;
+    int out_fd[2];
+    script_worker* w = &workers[i];
+
+    if (pipe2(out_fd, O_CLOEXEC) < 0)
+    {
+        perror(KRED"\npipe\n"KDEF);
+        return -1;
+    }
+
+    output_flush();
+    fflush(stderr);
+
+    w->pid = fork();
+
+    if (w->pid < 0)
+    {
+        perror(KRED"\nfork\n"KDEF);
+        close(out_fd[0]);
+        close(out_fd[1]);
+        return -1;
+    }
+
+    if (w->pid == 0)
+    {
+        //El script corre en una copia del shell ya inicializado: su directorio, entorno y tabla de trabajos son propios.
+        int null_fd = open("/dev/null", O_RDONLY);
+
+        for (int k = 0; k < count; k++)
+            if (workers[k].out_fd >= 0)
+                close(workers[k].out_fd);
+
+        dup2(null_fd, STDIN_FILENO);
+        dup2(out_fd[1], STDOUT_FILENO);
+        dup2(out_fd[1], STDERR_FILENO);
+        close(null_fd);
+        close(out_fd[0]);
+        close(out_fd[1]);
+
+        shell_terminal = -1;
+
+        myshell_run_batch(w->name);
+    }
+
+    close(out_fd[1]);
+    w->out_fd = out_fd[0];
+
+    return 0;
+}
+
+void relay_script_output(script_worker* w)
+{
+    char chunk[RELAY_BUFFER_SIZE];
+    ssize_t n = read(w->out_fd, chunk, sizeof(chunk));
+
+    if (n > 0)
+    {
+        w->pending = realloc(w->pending, w->pending_len + n);
+        memcpy(w->pending + w->pending_len, chunk, n);
+        w->pending_len += n;
+    }
+
+    //Las lineas completas se emiten precedidas por el nombre del script. Al terminar se emite tambien la linea incompleta.
+    size_t start = 0;
+    char* newline;
+
+    while ((newline = memchr(w->pending + start, ASCII_LINE_BREAK, w->pending_len - start)) != NULL)
+    {
+        size_t len = newline - (w->pending + start) + 1;
+
+        output_printf(KCYN"[%s]"KDEF" %.*s", w->name, (int) len, w->pending + start);
+        start += len;
+    }
 
-    //Verifico que la longitud de la entrada no supere el limite maximo establecido.
-    if((*endOfBuffer != ASCII_LINE_BREAK && fp == stdin) || (*endOfBuffer != ASCII_LINE_BREAK && *endOfBuffer != EOF && strlen(buffer) - 1 >= buffer_size && fp != stdin))
+    if (n <= 0)
     {
-        while(getchar() != ASCII_LINE_BREAK); //Limpia el buffer de entrada.
-        fprintf(stderr, KRED"\nExceeded max input length !\n\n"KDEF);
-        return INP_TO_LONG;
+        if (start < w->pending_len)
+            output_printf(KCYN"[%s]"KDEF" %.*s\n", w->name, (int) (w->pending_len - start), w->pending + start);
+
+        start = w->pending_len;
+        close(w->out_fd);
+        w->out_fd = -1;
     }
 
-    if(trim_white_space(buffer) == NULL)
+    memmove(w->pending, w->pending + start, w->pending_len - start);
+    w->pending_len -= start;
+
+    output_flush();
+}
+
+READ_INPUT_RESULT get_input(line_reader* reader, char** line)
+{
+    char* input;
+
+    if(line_reader_next(reader, &input) < 0)
+        return INP_END;
+
+    if((*line = trim_white_space(input)) == NULL)
         return INP_EMPTY_LINE;
 
     return INP_READ;
@@ -137,66 +472,185 @@ char* trim_white_space(char* str)
 
 void execute_input(char* input)
 {
-    COMMANDS_FLAGS flag;
-    char* command;
+    uint64_t start = stats_now();
     char* args;
-    char* input_cpy = malloc(sizeof(char) * strlen(input));
-
-    strcpy(input_cpy, input);
-
-    command = strtok_r(input, " ", &args);
+    COMMANDS_FLAGS flag = classify_input(input, &args);
 
-    for(flag = CONST_STR_ARR_SIZE(CMM_VALIDS) - 1; flag >= -1; flag--)
-        if(flag == CMM_EXTERN || !strcmp(CMM_VALIDS[flag], command)) 
-            break;
-    
     if (flag != CMM_EXTERN)
+    {
+        stats_record(STATS_PARSE, start);
         command_interprete(flag, args);
-    else
-        command_interprete(flag, input_cpy);
+        return;
+    }
+
+    //En los comandos externos el analisis incluye la separacion de la linea en etapas y argumentos.
+    job *j = build_job(input);
+
+    stats_record(STATS_PARSE, start);
 
-    free(input_cpy);
+    if (j)
+        last_exit_status = job_exit_status(launch_job(j));
+
+    output_sync();
+}
+
+COMMANDS_FLAGS find_builtin(const char* name, size_t len)
+{
+    int id = BUILTIN_SLOTS[builtin_hash(name, len, BUILTIN_HASH_SEED) & BUILTIN_HASH_MASK];
+
+    //Cada nombre tiene una posicion propia en la tabla, por lo que basta una sola comparacion para confirmarlo.
+    if (id >= 0 && BUILTINS[id].len == len && !memcmp(BUILTINS[id].name, name, len))
+        return id;
+
+    return CMM_EXTERN;
+}
+
+COMMANDS_FLAGS classify_input(char* input, char** args)
+{
+    COMMANDS_FLAGS flag;
+    size_t command_len = strcspn(input, " ");
+
+    *args = input + command_len;
+
+    flag = find_builtin(input, command_len);
+
+    //Una pipeline se ejecuta siempre como comando externo, aun si su primera etapa es un comando interno, salvo que este reciba el comando.
+    if(flag != CMM_EXTERN && BUILTINS[flag].kind != BUILTIN_PREFIX && **args && strchr(*args + 1, ASCII_PIPE))
+        flag = CMM_EXTERN;
+
+    //Las utilidades se ejecutan como programa externo si la linea necesita control de trabajos.
+    if(flag != CMM_EXTERN && BUILTINS[flag].kind == BUILTIN_UTILITY && strchr(*args, '&'))
+        flag = CMM_EXTERN;
+
+    while(**args == ASCII_SPACE)
+        (*args)++;
+
+    return flag;
 }
 
 void command_interprete(COMMANDS_FLAGS cmm, char* args)
 {
-    switch (cmm)
+    if (cmm == CMM_EXTERN)
+        execute_extern(args);
+    else
+        execute_builtin(cmm, args);
+
+    //La salida de cada comando se emite completa con una unica escritura, o junto con la de otros si no va a una terminal.
+    output_sync();
+}
+
+void execute_builtin(COMMANDS_FLAGS cmm, char* args)
+{
+    int saved[STANDARD_STREAMS];
+
+    //Los prefijos reciben un comando cuyas redirecciones se aplican al lanzarlo.
+    if (BUILTINS[cmm].kind == BUILTIN_PREFIX)
     {
-        case CMM_JOBS:
-            if (strlen(args) > 0)
-                fprintf(stderr, KRED"\nThe command does not allow parameters !\n\n"KDEF);
-            else
-                print_job_all_status();
-            
-            break;
+        BUILTINS[cmm].handler(args);
+        return;
+    }
 
-        case CMM_CD:
-            execute_cd(args);
-            break;
+    if (redirect_builtin(args, saved) < 0)
+    {
+        last_exit_status = EXIT_FAILURE;
+        return;
+    }
 
-        case CMM_ECHO:
-            execute_echo(args);
-            break;
+    BUILTINS[cmm].handler(args);
 
-        case CMM_CLR:
-            if (strlen(args) > 0)
-                fprintf(stderr, KRED"\nThe command does not allow parameters !\n\n"KDEF);
-            else
-                execute_clr();
+    restore_builtin_streams(saved);
+}
 
-            break;
+int redirect_builtin(char* args, int saved[STANDARD_STREAMS])
+{
+    char* read = args;
+    char* write = args;
 
-        case CMM_QUIT:
-            if (strlen(args) > 0)
-                fprintf(stderr, KRED"\nThe command does not allow parameters !\n\n"KDEF);
+    for (int fd = 0; fd < STANDARD_STREAMS; fd++)
+        saved[fd] = -1;
+
+    if (!strpbrk(args, "<>"))
+        return 0;
+
+    while (*read)
+    {
+        char* gap = read;
+
+        while (*read == ASCII_SPACE)
+            read++;
+
+        char* word = read;
+        char* end = word + strcspn(word, " ");
+        char next = *end;
+        int flags, fd;
+
+        *end = ASCII_END_OF_STRING;
+
+        //Las palabras que no son redirecciones se conservan junto con los espacios que las preceden.
+        if ((fd = parse_redirection_operator(&word, &flags)) < 0)
+        {
+            *end = next;
+            memmove(write, gap, end - gap);
+            write += end - gap;
+            read = end;
+            continue;
+        }
+
+        read = next ? end + 1 : end;
+
+        //El archivo puede estar pegado al operador ("<in", ">out") o ser la palabra siguiente.
+        if (*word == ASCII_END_OF_STRING)
+        {
+            while (*read == ASCII_SPACE)
+                read++;
+
+            word = read;
+            read += strcspn(read, " ");
+
+            if (*read)
+                *read++ = ASCII_END_OF_STRING;
+        }
+
+        int file_fd = *word ? open(word, flags | O_CLOEXEC, REDIRECT_FILE_MODE) : -1;
+
+        if (file_fd < 0)
+        {
+            if (*word)
+                output_error(KRED"\n%s: %s\n\n"KDEF, word, strerror(errno));
             else
-                execute_quit();
-            
-            break;
-    
-        default:
-            execute_extern(args);
-            break;
+                output_error(KRED"\nInvalid redirection !\n\n"KDEF);
+
+            restore_builtin_streams(saved);
+            return -1;
+        }
+
+        //Lo que el shell ya acumulo corresponde a la salida anterior a la redireccion.
+        output_flush();
+
+        if (saved[fd] < 0)
+            saved[fd] = fcntl(fd, F_DUPFD_CLOEXEC, STANDARD_STREAMS);
+
+        dup2(file_fd, fd);
+        close(file_fd);
+    }
+
+    *write = ASCII_END_OF_STRING;
+
+    return 0;
+}
+
+void restore_builtin_streams(int saved[STANDARD_STREAMS])
+{
+    output_flush();
+
+    for (int fd = 0; fd < STANDARD_STREAMS; fd++)
+    {
+        if (saved[fd] < 0)
+            continue;
+
+        dup2(saved[fd], fd);
+        close(saved[fd]);
+        saved[fd] = -1;
     }
 }
 
@@ -206,12 +660,12 @@ void execute_cd(char* dir)
         dir = getenv("OLDPWD");
     
     if (chdir(dir) != 0)
-        fprintf(stderr, KRED"\n%s\n\n"KDEF, strerror(errno));  
+        output_error(KRED"\n%s\n\n"KDEF, strerror(errno));  
     else
     {
         setenv("OLDPWD", getenv("PWD"), 1);
         setenv("PWD", getcwd(NULL, 1024), 1);
-        fprintf(stdout, "\n");
+        output_puts("\n");
     }
 }
 
@@ -222,49 +676,507 @@ void execute_echo(char* value)
 
     char *end_str;
     char *word = strtok_r(value, " ", &end_str);
+    int colored = isatty(STDOUT_FILENO);
 
-    fprintf(stdout, "\n");
+    //El color se aplica una sola vez a toda la linea en lugar de a cada fragmento, y solo en la terminal.
+    if (colored)
+        output_puts("\n"KBLU);
 
-    while (word != NULL)
+    for (int first = 1; word != NULL; first = 0)
     {
         char *end_word;
         char *sub_word = strtok_r(word, "$", &end_word);
 
+        if (!first)
+            output_puts(" ");
+
         if(*word != ASCII_MONEY_SIGN)
         {
-            fprintf(stdout, KBLU"%s"KDEF, sub_word);
+            output_puts(sub_word);
             sub_word = strtok_r(NULL, "$", &end_word);
         }
         
         while (sub_word != NULL)
         {
+            char status[12];
             char* envvar = getenv(sub_word);
 
+            if (!strcmp(sub_word, "?"))
+                snprintf(envvar = status, sizeof(status), "%d", last_exit_status);
+
             if(envvar)
-                fprintf(stdout, KBLU"%s"KDEF, envvar);
+                output_puts(envvar);
 
             sub_word = strtok_r(NULL, "$", &end_word);
         }
 
-        fprintf(stdout, " ");
-
         word = strtok_r(NULL, " ", &end_str);
     }
 
-    fprintf(stdout, "\n\n");
+    output_puts(colored ? KDEF"\n\n" : "\n");
 }
 
 void execute_extern(char* command)
 {
-    launch_job(new_job(new_process(command)));
+    job *j = build_job(command);
+
+    if (j)
+        last_exit_status = job_exit_status(launch_job(j));
 }
 
-void execute_clr(void)
+job* build_job(char* command)
 {
-    system("clear");
+    job *j = new_job();
+    char *end_stage;
+    char *stage = strtok_r(command, "|", &end_stage);
+
+    while (stage != NULL)
+    {
+        if (new_process(j, stage)->argc == 0)
+        {
+            output_error(KRED"\nInvalid pipeline !\n\n"KDEF);
+            last_exit_status = EXIT_FAILURE;
+            free_job(j);
+            return NULL;
+        }
+
+        stage = strtok_r(NULL, "|", &end_stage);
+    }
+
+    if (j->first_process == NULL)
+    {
+        free_job(j);
+        return NULL;
+    }
+
+    update_job_mode(j);
+
+    //Una etapa que solo contenia el '&' queda vacia al quitarlo ("&", "ls | &").
+    if (get_last_process(j)->argc == 0)
+    {
+        output_error(KRED"\nInvalid pipeline !\n\n"KDEF);
+        last_exit_status = EXIT_FAILURE;
+        free_job(j);
+        return NULL;
+    }
+
+    return j;
 }
 
-void execute_quit(void)
+void execute_time(char* args)
 {
-    exit(EXIT_SUCCESS);
+    if (*args == ASCII_END_OF_STRING)
+    {
+        output_error(KRED"\ntime: missing command\n\n"KDEF);
+        last_exit_status = EXIT_FAILURE;
+        return;
+    }
+
+    char* command_args;
+    COMMANDS_FLAGS flag = classify_input(args, &command_args);
+
+    //Los comandos externos se miden con los recursos que informa wait4 para cada proceso, al terminar el trabajo (aun en segundo plano).
+    if (flag == CMM_EXTERN)
+    {
+        job *j = build_job(args);
+
+        if (j)
+        {
+            j->timed = 1;
+            last_exit_status = job_exit_status(launch_job(j));
+        }
+
+        return;
+    }
+
+    //Los comandos internos corren en el propio shell: se mide la diferencia de sus recursos.
+    struct timespec start, end;
+    struct rusage before, after;
+    job_usage u;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    getrusage(RUSAGE_SELF, &before);
+
+    execute_builtin(flag, command_args);
+
+    getrusage(RUSAGE_SELF, &after);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    u.real = elapsed_seconds(&start, &end);
+    u.user = (after.ru_utime.tv_sec - before.ru_utime.tv_sec) + (after.ru_utime.tv_usec - before.ru_utime.tv_usec) / 1e6;
+    u.sys = (after.ru_stime.tv_sec - before.ru_stime.tv_sec) + (after.ru_stime.tv_usec - before.ru_stime.tv_usec) / 1e6;
+    u.maxrss = after.ru_maxrss;
+    u.nvcsw = after.ru_nvcsw - before.ru_nvcsw;
+    u.nivcsw = after.ru_nivcsw - before.ru_nivcsw;
+
+    print_usage(&u, 0);
+}
+
+void execute_compiled_extern(script_line* line)
+{
+    uint64_t start = stats_now();
+    job *j = new_job();
+    char *stage = line->stage_data;
+
+    for (int i = 0; i < line->stages; i++)
+    {
+        int argc;
+        char *args;
+
+        stage = script_cache_stage(stage, &argc, &args);
+
+        if (new_process_argv(j, args, argc)->argc == 0)
+        {
+            output_error(KRED"\nInvalid pipeline !\n\n"KDEF);
+            last_exit_status = EXIT_FAILURE;
+            free_job(j);
+            return;
+        }
+    }
+
+    if (j->first_process == NULL)
+    {
+        free_job(j);
+        return;
+    }
+
+    update_job_mode(j);
+
+    if (line->background)
+        j->mode = BACKGROUND_EXECUTION;
+
+    stats_record(STATS_PARSE, start);
+
+    last_exit_status = job_exit_status(launch_job(j));
+}
+
+int job_exit_status(int status)
+{
+    if (status < 0)
+        return EXIT_FAILURE;
+
+    if (WIFSIGNALED(status))
+        return 128 + WTERMSIG(status);
+
+    return WEXITSTATUS(status);
+}
+
+void execute_hash(char* args)
+{
+    char *end_str;
+    char *name = strtok_r(args, " ", &end_str);
+
+    if (name == NULL)
+    {
+        print_path_hash();
+        return;
+    }
+
+    if (!strcmp(name, "-r"))
+    {
+        path_hash_clear();
+        output_puts("\n");
+        return;
+    }
+
+    if (!strcmp(name, "-d"))
+    {
+        while ((name = strtok_r(NULL, " ", &end_str)) != NULL)
+            path_hash_remove(name);
+
+        output_puts("\n");
+        return;
+    }
+
+    for (; name != NULL; name = strtok_r(NULL, " ", &end_str))
+        if (strchr(name, '/') == NULL && path_hash_insert(name) < 0)
+            output_error(KRED"\nhash: %s: not found\n"KDEF, name);
+
+    output_puts("\n");
+}
+
+void execute_jobs(char* args)
+{
+    if (!strcmp(args, "-l"))
+        print_job_all_usage();
+    else if (check_no_arguments(args))
+        print_job_all_status();
+}
+
+void execute_bgmax(char* args)
+{
+    if (*args == ASCII_END_OF_STRING)
+    {
+        output_printf(KBLU"\nmax %d, running %d, queued %d\n\n"KDEF, background_max, background_running, get_queued_jobs_count());
+        return;
+    }
+
+    char* end;
+    long max = strtol(args, &end, 10);
+
+    if (*end || max < 0 || max > INT_MAX)
+    {
+        output_error(KRED"\nbgmax: %s: invalid number\n\n"KDEF, args);
+        last_exit_status = EXIT_FAILURE;
+        return;
+    }
+
+    set_background_max(max);
+    output_puts("\n");
+}
+
+/**
+ * @brief Separa la primera palabra de una cadena y avanza hasta la siguiente.
+ * 
+ * @param cursor Posicion actual en la cadena. Queda al comienzo de la siguiente palabra.
+ * @return char* Palabra separada. Cadena vacia si no quedan palabras.
+ */
+static char* take_word(char** cursor)
+{
+    char* word = *cursor;
+    char* end = word + strcspn(word, " ");
+
+    *cursor = end;
+
+    if (*end != ASCII_END_OF_STRING)
+    {
+        *end = ASCII_END_OF_STRING;
+        (*cursor)++;
+    }
+
+    while (**cursor == ASCII_SPACE)
+        (*cursor)++;
+
+    return word;
+}
+
+/**
+ * @brief Informa la politica aplicada a los trabajos en segundo plano.
+ * 
+ */
+static void print_background_policy(void)
+{
+    char policy[POLICY_STRING_SIZE];
+
+    format_policy(&background_policy, policy, sizeof(policy));
+
+    output_printf(KBLU"\nbackground: %s%s%s\n\n"KDEF,
+                  background_policy.automatic && !background_policy.has_cpus ? "cpu round-robin" : "",
+                  background_policy.automatic && !background_policy.has_cpus && *policy ? " " : "",
+                  *policy || background_policy.automatic ? policy : "default");
+}
+
+void execute_sched(char* args)
+{
+    job_policy policy;
+    int reset = 0;
+
+    policy_clear(&policy);
+
+    //Las opciones preceden al comando, que comienza en la primera palabra que no es una opcion.
+    while (*args == '-')
+    {
+        char* option = take_word(&args);
+        char* value = strcmp(option, "-x") ? take_word(&args) : NULL;
+        int valid = 1;
+
+        if (!strcmp(option, "-x"))
+            reset = 1;
+        else if (!strcmp(option, "-c"))
+        {
+            valid = parse_cpu_list(value, &policy.cpus) == 0;
+            policy.has_cpus = 1;
+        }
+        else if (!strcmp(option, "-n"))
+        {
+            char* end;
+
+            policy.nice = strtol(value, &end, 10);
+            policy.has_nice = 1;
+            valid = *value && !*end && policy.nice >= PRIO_MIN && policy.nice < PRIO_MAX;
+        }
+        else if (!strcmp(option, "-i"))
+            valid = parse_io_class(value, &policy) == 0;
+        else
+        {
+            output_error(KRED"\nsched: %s: invalid option\n\n"KDEF, option);
+            last_exit_status = EXIT_FAILURE;
+            return;
+        }
+
+        if (!valid)
+        {
+            output_error(KRED"\nsched: %s: invalid value '%s'\n\n"KDEF, option, value);
+            last_exit_status = EXIT_FAILURE;
+            return;
+        }
+    }
+
+    if (*args == ASCII_END_OF_STRING)
+    {
+        if (!reset && !policy_is_set(&policy))
+        {
+            print_background_policy();
+            return;
+        }
+
+        if (reset)
+        {
+            policy_clear(&background_policy);
+            background_policy.automatic = 1;
+        }
+
+        //Fijar las CPUs de forma explicita reemplaza el reparto round-robin.
+        if (policy.has_cpus)
+        {
+            background_policy.cpus = policy.cpus;
+            background_policy.has_cpus = 1;
+            background_policy.automatic = 0;
+        }
+
+        if (policy.has_nice)
+        {
+            background_policy.nice = policy.nice;
+            background_policy.has_nice = 1;
+        }
+
+        if (policy.io_class != IOPRIO_CLASS_NONE)
+        {
+            background_policy.io_class = policy.io_class;
+            background_policy.io_level = policy.io_level;
+        }
+
+        output_puts("\n");
+        return;
+    }
+
+    if (reset)
+    {
+        output_error(KRED"\nsched: -x does not take a command\n\n"KDEF);
+        last_exit_status = EXIT_FAILURE;
+        return;
+    }
+
+    char* command_args;
+    COMMANDS_FLAGS flag = classify_input(args, &command_args);
+
+    //La politica se aplica a procesos: las utilidades se ejecutan como programa externo y el resto de los internos no se admite.
+    if (flag != CMM_EXTERN && BUILTINS[flag].kind != BUILTIN_UTILITY)
+    {
+        output_error(KRED"\nsched: %s: is a shell builtin\n\n"KDEF, BUILTINS[flag].name);
+        last_exit_status = EXIT_FAILURE;
+        return;
+    }
+
+    job *j = build_job(args);
+
+    if (j)
+    {
+        j->policy = policy;
+        last_exit_status = job_exit_status(launch_job(j));
+    }
+}
+
+void execute_output(char* args)
+{
+    long lines = 0;
+    int follow = 0;
+    char* end;
+
+    while (*args == '-')
+    {
+        char* option = take_word(&args);
+
+        if (!strcmp(option, "-f"))
+            follow = 1;
+        else if (!strcmp(option, "-n"))
+        {
+            char* value = take_word(&args);
+
+            lines = strtol(value, &end, 10);
+
+            if (!*value || *end || lines <= 0 || lines > INT_MAX)
+            {
+                output_error(KRED"\noutput: %s: invalid number of lines\n\n"KDEF, value);
+                last_exit_status = EXIT_FAILURE;
+                return;
+            }
+        }
+        else
+        {
+            output_error(KRED"\noutput: %s: invalid option\n\n"KDEF, option);
+            last_exit_status = EXIT_FAILURE;
+            return;
+        }
+    }
+
+    char* id = take_word(&args);
+    job* j;
+
+    if (*id == ASCII_END_OF_STRING)
+        j = get_last_job();
+    else
+    {
+        long value = strtol(id + (*id == '%'), &end, 10);
+
+        j = *end || value <= 0 || value > INT_MAX ? NULL : get_job_by_id(value);
+    }
+
+    if (!j || *args != ASCII_END_OF_STRING)
+    {
+        output_error(KRED"\noutput: %s: no such job\n\n"KDEF, *id ? id : "current");
+        last_exit_status = EXIT_FAILURE;
+        return;
+    }
+
+    //Se recoge primero lo que haya en los pipes, para mostrar la salida hasta este momento.
+    if (j->mode == BACKGROUND_EXECUTION)
+        collect_job_output(j);
+
+    output_puts("\n");
+
+    uint64_t from = lines ? ring_tail_lines(&j->output, lines) : ring_first(&j->output);
+
+    //Con "-f" la salida se muestra desde el comienzo pedido y luego a medida que llega.
+    j->output_shown = from;
+
+    if (follow && j->mode == BACKGROUND_EXECUTION)
+        follow_job_output(j);
+    else if (print_job_output(j, from))
+        output_puts("\n");
+}
+
+void execute_stats(char* args)
+{
+    if (!strcmp(args, "-r"))
+    {
+        stats_reset();
+        output_puts("\n");
+    }
+    else if (check_no_arguments(args))
+        print_stats();
+}
+
+void execute_clr(char* args)
+{
+    if (!check_no_arguments(args))
+        return;
+
+    output_puts(CLEAR_SCREEN_SEQUENCE);
+}
+
+void execute_quit(char* args)
+{
+    if (check_no_arguments(args))
+        exit(EXIT_SUCCESS);
+}
+
+int check_no_arguments(char* args)
+{
+    if (*args == ASCII_END_OF_STRING)
+        return 1;
+
+    output_error(KRED"\nThe command does not allow parameters !\n\n"KDEF);
+
+    return 0;
 }
\ No newline at end of file
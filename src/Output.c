@@ -0,0 +1,107 @@
+/**
+ * @file Output.c
+ * @author Bottini, Franco Nicolas
+ * @brief Implementacion del buffer de salida del shell.
+ * @version 1.2
+ * @date Septiembre de 2022
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/Output.h"
+
+output_buffer shell_output = { NULL, 0, 0, 0 };
+
+static char* output_reserve(size_t n)
+{
+    if (shell_output.len + n > shell_output.capacity)
+    {
+        while (shell_output.len + n > shell_output.capacity)
+            shell_output.capacity = shell_output.capacity ? shell_output.capacity * 2 : OUTPUT_INITIAL_SIZE;
+
+        shell_output.data = realloc(shell_output.data, shell_output.capacity);
+    }
+
+    return shell_output.data + shell_output.len;
+}
+
+void output_append(const char *data, size_t len)
+{
+    memcpy(output_reserve(len), data, len);
+    shell_output.len += len;
+}
+
+void output_puts(const char *str)
+{
+    output_append(str, strlen(str));
+}
+
+void output_printf(const char *format, ...)
+{
+    va_list args;
+    size_t available = shell_output.capacity - shell_output.len;
+
+    //Se intenta formatear directamente en el espacio libre; si no alcanza se reserva lo necesario y se repite.
+    va_start(args, format);
+    int n = vsnprintf(shell_output.data ? shell_output.data + shell_output.len : NULL, available, format, args);
+    va_end(args);
+
+    if (n < 0)
+        return;
+
+    if ((size_t) n >= available)
+    {
+        output_reserve(n + 1);
+
+        va_start(args, format);
+        vsnprintf(shell_output.data + shell_output.len, n + 1, format, args);
+        va_end(args);
+    }
+
+    shell_output.len += n;
+}
+
+void output_error(const char *format, ...)
+{
+    va_list args;
+
+    output_flush();
+
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+void output_flush(void)
+{
+    //Lo que se haya escrito con stdio va antes, para no alterar el orden de la salida.
+    fflush(stdout);
+
+    size_t written = 0;
+
+    while (written < shell_output.len)
+    {
+        ssize_t n = write(STDOUT_FILENO, shell_output.data + written, shell_output.len - written);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+
+        written += n;
+    }
+
+    shell_output.len = 0;
+}
+
+void output_sync(void)
+{
+    if (shell_output.len >= shell_output.block)
+        output_flush();
+}
+
+void output_set_block_buffered(int enabled)
+{
+    shell_output.block = enabled ? OUTPUT_BLOCK_SIZE : 0;
+}
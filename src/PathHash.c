@@ -0,0 +1,212 @@
+/**
+ * @file PathHash.c
+ * @author Bottini, Franco Nicolas
+ * @brief Implementacion de la tabla hash de rutas de comandos.
+ * @version 1.2
+ * @date Septiembre de 2022
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include "../inc/PathHash.h"
+
+static path_hash_entry *table = NULL;   /** Tabla con direccionamiento abierto **/
+static size_t table_size = 0;           /** Capacidad de la tabla **/
+static size_t table_count = 0;          /** Entradas ocupadas **/
+static char *table_path = NULL;         /** Valor de PATH con el que se resolvieron las entradas **/
+
+static size_t hash_name(const char* name)
+{
+    size_t h = 14695981039346656037UL;
+
+    while (*name)
+        h = (h ^ (unsigned char) *name++) * 1099511628211UL;
+
+    return h;
+}
+
+static path_hash_entry* find_slot(path_hash_entry *t, size_t size, const char* name)
+{
+    size_t i = hash_name(name) & (size - 1);
+
+    while (t[i].name && strcmp(t[i].name, name))
+        i = (i + 1) & (size - 1);
+
+    return &t[i];
+}
+
+static void grow_table(void)
+{
+    size_t new_size = table_size ? table_size * 2 : PATH_HASH_INITIAL_SIZE;
+    path_hash_entry *new_table = calloc(new_size, sizeof(path_hash_entry));
+
+    for (size_t i = 0; i < table_size; i++)
+        if (table[i].name)
+            *find_slot(new_table, new_size, table[i].name) = table[i];
+
+    free(table);
+    table = new_table;
+    table_size = new_size;
+}
+
+//Vacia la tabla si PATH cambio desde que se resolvieron las entradas.
+static void check_path(void)
+{
+    const char* path = getenv("PATH");
+
+    if (!path)
+        path = "";
+
+    if (table_path && !strcmp(table_path, path))
+        return;
+
+    path_hash_clear();
+    free(table_path);
+    table_path = strdup(path);
+}
+
+static path_hash_entry* add_entry(const char* name)
+{
+    char* path = resolve_command_path(name);
+
+    if (!path)
+        return NULL;
+
+    if ((table_count + 1) * 2 > table_size)
+        grow_table();
+
+    path_hash_entry *e = find_slot(table, table_size, name);
+
+    e->name = strdup(name);
+    e->path = path;
+    e->hits = 0;
+    table_count++;
+
+    return e;
+}
+
+const char* path_hash_lookup(const char* name)
+{
+    check_path();
+
+    path_hash_entry *e = table_size ? find_slot(table, table_size, name) : NULL;
+
+    if (!e || !e->name)
+        e = add_entry(name);
+
+    if (!e)
+        return NULL;
+
+    e->hits++;
+
+    return e->path;
+}
+
+int path_hash_insert(const char* name)
+{
+    check_path();
+
+    if (table_size && find_slot(table, table_size, name)->name)
+        path_hash_remove(name);
+
+    return add_entry(name) ? 0 : -1;
+}
+
+void path_hash_remove(const char* name)
+{
+    if (!table_size)
+        return;
+
+    path_hash_entry *e = find_slot(table, table_size, name);
+
+    if (!e->name)
+        return;
+
+    free(e->name);
+    free(e->path);
+    e->name = e->path = NULL;
+    table_count--;
+
+    //Reubica las entradas siguientes del cluster para no cortar las secuencias de sondeo.
+    size_t i = (e - table + 1) & (table_size - 1);
+
+    while (table[i].name)
+    {
+        path_hash_entry moved = table[i];
+
+        table[i].name = NULL;
+        *find_slot(table, table_size, moved.name) = moved;
+        i = (i + 1) & (table_size - 1);
+    }
+}
+
+void path_hash_clear(void)
+{
+    for (size_t i = 0; i < table_size; i++)
+    {
+        free(table[i].name);
+        free(table[i].path);
+    }
+
+    if (table_size)
+        memset(table, 0, table_size * sizeof(path_hash_entry));
+
+    table_count = 0;
+}
+
+void print_path_hash(void)
+{
+    if (!table_count)
+    {
+        output_puts("\nhash: hash table empty\n\n");
+        return;
+    }
+
+    output_puts("\nhits\tcommand\n");
+
+    for (size_t i = 0; i < table_size; i++)
+        if (table[i].name)
+            output_printf("%4u\t%s\n", table[i].hits, table[i].path);
+
+    output_puts("\n");
+}
+
+char* resolve_command_path(const char* name)
+{
+    const char* dirs = getenv("PATH");
+    size_t name_len = strlen(name);
+    struct stat st;
+
+    if (!dirs || !*name)
+        return NULL;
+
+    while (1)
+    {
+        const char* end = strchr(dirs, ':');
+        size_t dir_len = end ? (size_t) (end - dirs) : strlen(dirs);
+        char* candidate = malloc(dir_len + name_len + 3);
+
+        //Un componente vacio en PATH equivale al directorio actual.
+        if (dir_len == 0)
+            strcpy(candidate, ".");
+        else
+        {
+            memcpy(candidate, dirs, dir_len);
+            candidate[dir_len] = '\0';
+        }
+
+        strcat(candidate, "/");
+        strcat(candidate, name);
+
+        if (access(candidate, X_OK) == 0 && stat(candidate, &st) == 0 && S_ISREG(st.st_mode))
+            return candidate;
+
+        free(candidate);
+
+        if (!end)
+            return NULL;
+
+        dirs = end + 1;
+    }
+}
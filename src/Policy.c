@@ -0,0 +1,202 @@
+/**
+ * @file Policy.c
+ * @author Bottini, Franco Nicolas
+ * @brief Implementacion de las politicas de planificacion de los trabajos.
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../inc/Policy.h"
+
+const char* IOPRIO_CLASS_STRING[] = {
+    "none",
+    "rt",
+    "be",
+    "idle"
+};
+
+static cpu_set_t available_cpus;    /** CPUs en las que puede correr el shell **/
+static int available_count = 0;     /** Numero de CPUs disponibles **/
+static int next_cpu = 0;            /** Proxima CPU a asignar en orden round-robin **/
+
+void policy_clear(job_policy *policy)
+{
+    memset(policy, 0, sizeof(job_policy));
+}
+
+int policy_is_set(const job_policy *policy)
+{
+    return policy->has_cpus || policy->has_nice || policy->io_class != IOPRIO_CLASS_NONE;
+}
+
+void policy_setup(void)
+{
+    if (sched_getaffinity(0, sizeof(available_cpus), &available_cpus) < 0)
+        CPU_ZERO(&available_cpus);
+
+    available_count = CPU_COUNT(&available_cpus);
+}
+
+int policy_assign_cpu(job_policy *policy)
+{
+    if (available_count < 2)
+        return -1;
+
+    //Se avanza hasta la siguiente CPU del conjunto disponible, que no tiene por que ser contiguo.
+    while (!CPU_ISSET(next_cpu, &available_cpus))
+        next_cpu = (next_cpu + 1) % CPU_SETSIZE;
+
+    CPU_ZERO(&policy->cpus);
+    CPU_SET(next_cpu, &policy->cpus);
+    policy->has_cpus = 1;
+    policy->automatic = 1;
+
+    next_cpu = (next_cpu + 1) % CPU_SETSIZE;
+
+    return 0;
+}
+
+int apply_policy(const job_policy *policy, pid_t pid)
+{
+    int result = 0;
+
+    if (policy->has_cpus && sched_setaffinity(pid, sizeof(cpu_set_t), &policy->cpus) < 0)
+    {
+        fprintf(stderr, "sched_setaffinity: %s\n", strerror(errno));
+        result = -1;
+    }
+
+    if (policy->has_nice && setpriority(PRIO_PROCESS, pid, policy->nice) < 0)
+    {
+        fprintf(stderr, "setpriority: %s\n", strerror(errno));
+        result = -1;
+    }
+
+    if (policy->io_class != IOPRIO_CLASS_NONE &&
+        syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, pid, (policy->io_class << IOPRIO_CLASS_SHIFT) | policy->io_level) < 0)
+    {
+        fprintf(stderr, "ioprio_set: %s\n", strerror(errno));
+        result = -1;
+    }
+
+    return result;
+}
+
+int parse_cpu_list(const char *list, cpu_set_t *set)
+{
+    const char *c = list;
+
+    CPU_ZERO(set);
+
+    while (*c)
+    {
+        char *end;
+        long first = strtol(c, &end, 10), last;
+
+        if (end == c || first < 0 || first >= CPU_SETSIZE)
+            return -1;
+
+        last = first;
+        c = end;
+
+        if (*c == '-')
+        {
+            last = strtol(c + 1, &end, 10);
+
+            if (end == c + 1 || last < first || last >= CPU_SETSIZE)
+                return -1;
+
+            c = end;
+        }
+
+        for (long cpu = first; cpu <= last; cpu++)
+            CPU_SET(cpu, set);
+
+        if (*c == ',')
+            c++;
+        else if (*c)
+            return -1;
+    }
+
+    return CPU_COUNT(set) > 0 ? 0 : -1;
+}
+
+int parse_io_class(const char *spec, job_policy *policy)
+{
+    size_t len = strcspn(spec, ":");
+    int io_class = IOPRIO_CLASS_NONE;
+
+    for (int i = IOPRIO_CLASS_RT; i <= IOPRIO_CLASS_IDLE; i++)
+        if ((strlen(IOPRIO_CLASS_STRING[i]) == len && !strncmp(spec, IOPRIO_CLASS_STRING[i], len)) ||
+            (len == 1 && *spec == '0' + i))
+            io_class = i;
+
+    if (io_class == IOPRIO_CLASS_NONE)
+        return -1;
+
+    policy->io_class = io_class;
+    policy->io_level = IOPRIO_DEFAULT_LEVEL;
+
+    //La clase idle no tiene niveles.
+    if (spec[len] == ':')
+    {
+        char *end;
+        long level = strtol(spec + len + 1, &end, 10);
+
+        if (*end || end == spec + len + 1 || level < 0 || level >= IOPRIO_LEVELS || io_class == IOPRIO_CLASS_IDLE)
+            return -1;
+
+        policy->io_level = level;
+    }
+
+    if (io_class == IOPRIO_CLASS_IDLE)
+        policy->io_level = 0;
+
+    return 0;
+}
+
+void format_policy(const job_policy *policy, char *buffer, size_t size)
+{
+    size_t len = 0;
+
+    buffer[0] = '\0';
+
+    if (policy->has_cpus)
+    {
+        len += snprintf(buffer + len, size - len, "cpu ");
+
+        //Las CPUs consecutivas se agrupan en rangos.
+        for (int cpu = 0, first = 1; cpu < CPU_SETSIZE && len < size; cpu++)
+        {
+            if (!CPU_ISSET(cpu, &policy->cpus))
+                continue;
+
+            int last = cpu;
+
+            while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &policy->cpus))
+                last++;
+
+            if (last == cpu)
+                len += snprintf(buffer + len, size - len, "%s%d", first ? "" : ",", cpu);
+            else
+                len += snprintf(buffer + len, size - len, "%s%d-%d", first ? "" : ",", cpu, last);
+
+            first = 0;
+            cpu = last;
+        }
+
+        if (policy->automatic && len < size)
+            len += snprintf(buffer + len, size - len, " (auto)");
+    }
+
+    if (policy->has_nice && len < size)
+        len += snprintf(buffer + len, size - len, "%snice %d", len ? " " : "", policy->nice);
+
+    if (policy->io_class == IOPRIO_CLASS_IDLE && len < size)
+        snprintf(buffer + len, size - len, "%sio idle", len ? " " : "");
+    else if (policy->io_class != IOPRIO_CLASS_NONE && len < size)
+        snprintf(buffer + len, size - len, "%sio %s:%d", len ? " " : "", IOPRIO_CLASS_STRING[policy->io_class], policy->io_level);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file RingBuffer.c
+ * @author Bottini, Franco Nicolas
+ * @brief Implementacion del buffer circular.
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../inc/RingBuffer.h"
+
+void ring_init(ring_buffer *r, char *data, size_t size)
+{
+    r->data = data;
+    r->size = data ? size : 0;
+    r->written = 0;
+}
+
+void ring_write(ring_buffer *r, const char *data, size_t n)
+{
+    if (r->size == 0)
+        return;
+
+    //De una escritura mayor que el buffer solo sobreviven los ultimos bytes.
+    if (n > r->size)
+    {
+        r->written += n - r->size;
+        data += n - r->size;
+        n = r->size;
+    }
+
+    size_t at = r->written % r->size;
+    size_t first = n < r->size - at ? n : r->size - at;
+
+    memcpy(r->data + at, data, first);
+    memcpy(r->data, data + first, n - first);
+
+    r->written += n;
+}
+
+uint64_t ring_first(const ring_buffer *r)
+{
+    return r->written > r->size ? r->written - r->size : 0;
+}
+
+int ring_segments(const ring_buffer *r, uint64_t from, struct iovec iov[2])
+{
+    uint64_t first = ring_first(r);
+
+    if (from < first)
+        from = first;
+
+    if (from >= r->written)
+        return 0;
+
+    size_t at = from % r->size;
+    size_t len = r->written - from;
+    size_t head = len < r->size - at ? len : r->size - at;
+
+    iov[0] = (struct iovec) { .iov_base = r->data + at, .iov_len = head };
+    iov[1] = (struct iovec) { .iov_base = r->data, .iov_len = len - head };
+
+    return len > head ? 2 : 1;
+}
+
+uint64_t ring_next_line(const ring_buffer *r, uint64_t from)
+{
+    uint64_t first = ring_first(r);
+
+    if (from < first)
+        from = first;
+
+    for (uint64_t pos = from; pos < r->written; pos++)
+        if (r->data[pos % r->size] == '\n')
+            return pos + 1;
+
+    return from;
+}
+
+uint64_t ring_tail_lines(const ring_buffer *r, int lines)
+{
+    uint64_t first = ring_first(r);
+    uint64_t pos = r->written;
+
+    //El salto de linea final pertenece a la ultima linea, no comienza una nueva.
+    if (pos > first && r->data[(pos - 1) % r->size] == '\n')
+        pos--;
+
+    while (pos > first)
+    {
+        if (r->data[(pos - 1) % r->size] == '\n' && --lines <= 0)
+            return pos;
+
+        pos--;
+    }
+
+    return first;
+}
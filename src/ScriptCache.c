@@ -0,0 +1,310 @@
+/**
+ * @file ScriptCache.c
+ * @author Bottini, Franco Nicolas
+ * @brief Implementacion de la forma compilada de los batchfiles.
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../inc/ScriptCache.h"
+
+/** Alineacion de cada linea compilada, para leer su cabecera directamente desde el mapeo **/
+#define RECORD_ALIGNMENT sizeof(uint32_t)
+
+static char* cache_path(const char *script)
+{
+    const char *name = strrchr(script, '/');
+    size_t dir_len = name ? (size_t) (name - script + 1) : 0;
+    char *path;
+
+    name = name ? name + 1 : script;
+
+    if (asprintf(&path, "%.*s.%s%s", (int) dir_len, script, name, SCRIPT_CACHE_SUFFIX) < 0)
+        return NULL;
+
+    return path;
+}
+
+static uint64_t checksum(const char *data, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < length; i++)
+        hash = (hash ^ (unsigned char) data[i]) * 1099511628211ULL;
+
+    return hash;
+}
+
+static int header_matches(const script_cache *c, const script_cache_header *h)
+{
+    return h->magic == SCRIPT_CACHE_MAGIC &&
+           h->version == SCRIPT_CACHE_VERSION &&
+           h->signature == c->signature &&
+           h->mtime_sec == (int64_t) c->source.st_mtim.tv_sec &&
+           h->mtime_nsec == (int64_t) c->source.st_mtim.tv_nsec &&
+           h->size == (uint64_t) c->source.st_size &&
+           h->inode == (uint64_t) c->source.st_ino;
+}
+
+static void load_cache(script_cache *c)
+{
+    int fd = open(c->path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+
+    if (fd < 0)
+        return;
+
+    if (fstat(fd, &st) == 0 && (size_t) st.st_size >= sizeof(script_cache_header))
+    {
+        //El mapeo es privado y escribible porque los comandos internos separan sus argumentos en el mismo buffer.
+        void *map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+        if (map != MAP_FAILED)
+        {
+            script_cache_header *h = map;
+
+            //Un archivo truncado o dañado se descarta y el batchfile se vuelve a compilar.
+            if (header_matches(c, h) && h->length == st.st_size - sizeof(script_cache_header) &&
+                h->checksum == checksum((char*) map + sizeof(script_cache_header), h->length))
+            {
+                c->map = map;
+                c->map_size = st.st_size;
+                c->data = (char*) map + sizeof(script_cache_header);
+                c->length = h->length;
+                c->loaded = 1;
+            }
+            else
+                munmap(map, st.st_size);
+        }
+    }
+
+    close(fd);
+}
+
+static char* reserve(script_cache *c, size_t n)
+{
+    if (c->length + n > c->capacity)
+    {
+        while (c->length + n > c->capacity)
+            c->capacity = c->capacity ? c->capacity * 2 : 4096;
+
+        c->data = realloc(c->data, c->capacity);
+    }
+
+    c->length += n;
+
+    return c->data + c->length - n;
+}
+
+static void append_string(script_cache *c, const char *str, size_t len)
+{
+    char *dst = reserve(c, len + 1);
+
+    memcpy(dst, str, len);
+    dst[len] = '\0';
+}
+
+static size_t begin_record(script_cache *c, const char *text, int command)
+{
+    size_t start = c->length;
+    script_cache_record *r = (script_cache_record*) reserve(c, sizeof(script_cache_record));
+
+    r->command = command;
+    r->background = 0;
+    r->stages = 0;
+
+    append_string(c, text, strlen(text));
+
+    return start;
+}
+
+static void end_record(script_cache *c, size_t start)
+{
+    size_t padding = (RECORD_ALIGNMENT - (c->length - start) % RECORD_ALIGNMENT) % RECORD_ALIGNMENT;
+
+    memset(reserve(c, padding), 0, padding);
+    ((script_cache_record*) (c->data + start))->length = c->length - start;
+}
+
+script_cache* script_cache_open(const char *script, uint64_t signature)
+{
+    script_cache *c = calloc(1, sizeof(script_cache));
+
+    if (stat(script, &c->source) < 0)
+    {
+        free(c);
+        return NULL;
+    }
+
+    c->signature = signature;
+
+    const char *env = getenv(SCRIPT_CACHE_ENV);
+
+    if (env && !strcmp(env, "0"))
+        return c;
+
+    if (S_ISREG(c->source.st_mode) && (c->path = cache_path(script)) != NULL)
+        load_cache(c);
+
+    return c;
+}
+
+void script_cache_add_builtin(script_cache *c, const char *text, int command, const char *args)
+{
+    size_t start = begin_record(c, text, command);
+
+    append_string(c, args, strlen(args));
+    end_record(c, start);
+}
+
+void script_cache_add_extern(script_cache *c, const char *text)
+{
+    size_t start = begin_record(c, text, -1);
+    size_t argc_offset = 0, last_arg = 0;
+    uint32_t stages = 0, argc = 0, background = 0;
+    char *copy = strdup(text);
+    char *end_stage;
+
+    //Las etapas y argumentos se separan igual que al interpretar la linea: las etapas vacias se ignoran.
+    for (char *stage = strtok_r(copy, "|", &end_stage); stage; stage = strtok_r(NULL, "|", &end_stage))
+    {
+        char *end_arg;
+
+        argc_offset = c->length;
+        argc = 0;
+        reserve(c, sizeof(uint32_t));
+
+        for (char *arg = strtok_r(stage, " ", &end_arg); arg; arg = strtok_r(NULL, " ", &end_arg))
+        {
+            last_arg = c->length;
+            append_string(c, arg, strlen(arg));
+            argc++;
+        }
+
+        memcpy(c->data + argc_offset, &argc, sizeof(uint32_t));
+        stages++;
+    }
+
+    //El '&' final es siempre el ultimo argumento agregado, por lo que se descarta retrocediendo el buffer.
+    if (argc > 0 && !strcmp(c->data + last_arg, "&"))
+    {
+        c->length = last_arg;
+        argc--;
+        memcpy(c->data + argc_offset, &argc, sizeof(uint32_t));
+        background = 1;
+    }
+
+    free(copy);
+
+    script_cache_record *r = (script_cache_record*) (c->data + start);
+
+    r->stages = stages;
+    r->background = background;
+
+    end_record(c, start);
+}
+
+int script_cache_save(script_cache *c)
+{
+    if (c->path == NULL)
+        return -1;
+
+    char *tmp_path;
+
+    if (asprintf(&tmp_path, "%s.XXXXXX", c->path) < 0)
+        return -1;
+
+    int fd = mkostemp(tmp_path, O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        free(tmp_path);
+        return -1;
+    }
+
+    //El archivo temporal se crea solo para el usuario: se le dan los permisos de lectura del batchfile.
+    fchmod(fd, c->source.st_mode & 0666);
+
+    script_cache_header h = {
+        .magic = SCRIPT_CACHE_MAGIC,
+        .version = SCRIPT_CACHE_VERSION,
+        .signature = c->signature,
+        .mtime_sec = c->source.st_mtim.tv_sec,
+        .mtime_nsec = c->source.st_mtim.tv_nsec,
+        .size = c->source.st_size,
+        .inode = c->source.st_ino,
+        .length = c->length,
+        .checksum = checksum(c->data, c->length)
+    };
+
+    struct iovec iov[2] = {
+        { .iov_base = &h, .iov_len = sizeof(h) },
+        { .iov_base = c->data, .iov_len = c->length }
+    };
+
+    int result = writev(fd, iov, 2) == (ssize_t) (sizeof(h) + c->length) ? 0 : -1;
+
+    if (close(fd) < 0 || result < 0 || rename(tmp_path, c->path) < 0)
+    {
+        unlink(tmp_path);
+        result = -1;
+    }
+
+    free(tmp_path);
+
+    return result;
+}
+
+int script_cache_next(script_cache *c, script_line *line)
+{
+    if (c->offset + sizeof(script_cache_record) > c->length)
+        return 0;
+
+    script_cache_record *r = (script_cache_record*) (c->data + c->offset);
+
+    //Una linea con longitud invalida (archivo compilado corrupto) termina la ejecucion en lugar de leer fuera del buffer.
+    if (r->length < sizeof(script_cache_record) || r->length > c->length - c->offset)
+        return 0;
+
+    line->text = (char*) (r + 1);
+    line->command = r->command;
+    line->background = r->background;
+    line->stages = r->stages;
+    line->args = line->text + strlen(line->text) + 1;
+    line->stage_data = line->args;
+
+    c->offset += r->length;
+
+    return 1;
+}
+
+char* script_cache_stage(char *stage, int *argc, char **args)
+{
+    uint32_t n;
+
+    memcpy(&n, stage, sizeof(uint32_t));
+
+    *argc = n;
+    *args = stage + sizeof(uint32_t);
+
+    char *next = *args;
+
+    while (n-- > 0)
+        next += strlen(next) + 1;
+
+    return next;
+}
+
+void script_cache_close(script_cache *c)
+{
+    if (c->map)
+        munmap(c->map, c->map_size);
+    else
+        free(c->data);
+
+    free(c->path);
+    free(c);
+}
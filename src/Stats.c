@@ -0,0 +1,80 @@
+/**
+ * @file Stats.c
+ * @author Bottini, Franco Nicolas
+ * @brief Implementacion de los histogramas de latencia del shell.
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../inc/JobControl.h"
+
+const char* STATS_PHASE_STRING[] = {
+    "parse",
+    "path",
+    "launch",
+    "wait",
+    "drain"
+};
+
+histogram stats_histograms[STATS_PHASES_COUNT];
+
+static uint64_t bucket_upper_bound(int bucket)
+{
+    if (bucket < HISTOGRAM_SUB_BUCKETS)
+        return bucket;
+
+    int shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+    uint64_t lower = (uint64_t) (HISTOGRAM_SUB_BUCKETS + bucket % HISTOGRAM_SUB_BUCKETS) << shift;
+
+    return lower + (1ULL << shift) - 1;
+}
+
+uint64_t histogram_percentile(const histogram *h, double p)
+{
+    if (h->count == 0)
+        return 0;
+
+    //Posicion (desde 1) de la muestra buscada entre todas las registradas.
+    uint64_t rank = (uint64_t) (p * (h->count - 1)) + 1;
+    uint64_t seen = 0;
+
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        seen += h->buckets[i];
+
+        if (seen >= rank)
+        {
+            uint64_t bound = bucket_upper_bound(i);
+
+            return bound < h->max ? bound : h->max;
+        }
+    }
+
+    return h->max;
+}
+
+void stats_reset(void)
+{
+    memset(stats_histograms, 0, sizeof(stats_histograms));
+}
+
+void print_stats(void)
+{
+    output_printf(KBLU"\n%-8s %10s %10s %10s %10s %10s\n"KDEF, "phase", "count", "mean(us)", "p50(us)", "p99(us)", "max(us)");
+
+    for (int i = 0; i < STATS_PHASES_COUNT; i++)
+    {
+        const histogram *h = &stats_histograms[i];
+
+        output_printf("%-8s %10llu %10.1f %10.1f %10.1f %10.1f\n", STATS_PHASE_STRING[i], (unsigned long long) h->count,
+                      h->count ? h->sum / 1e3 / h->count : 0.0,
+                      histogram_percentile(h, 0.50) / 1e3,
+                      histogram_percentile(h, 0.99) / 1e3,
+                      h->max / 1e3);
+    }
+
+    output_puts("\n");
+}
@@ -0,0 +1,885 @@
+/**
+ * @file Utilities.c
+ * @author Bottini, Franco Nicolas
+ * @brief Implementacion de las utilidades ejecutadas dentro del shell.
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../inc/MyShell.h"
+
+#include <ctype.h>
+#include <sys/stat.h>
+
+void execute_true(char* args)
+{
+    (void) args;
+
+    last_exit_status = EXIT_SUCCESS;
+}
+
+void execute_false(char* args)
+{
+    (void) args;
+
+    last_exit_status = EXIT_FAILURE;
+}
+
+void execute_pwd(char* args)
+{
+    int argc, physical = 0;
+    char** argv = split_arguments(args, &argc);
+
+    last_exit_status = EXIT_SUCCESS;
+
+    for (int i = 0; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-P"))
+            physical = 1;
+        else if (!strcmp(argv[i], "-L"))
+            physical = 0;
+        else
+        {
+            output_error(KRED"\npwd: %s: invalid option\n\n"KDEF, argv[i]);
+            last_exit_status = EXIT_FAILURE;
+        }
+    }
+
+    free(argv);
+
+    if (last_exit_status != EXIT_SUCCESS)
+        return;
+
+    //La ruta logica se toma de PWD solo si es absoluta, sin componentes "." o "..", y corresponde al directorio actual.
+    const char* pwd = getenv("PWD");
+    struct stat pwd_st, dot_st;
+
+    if (!physical && pwd && *pwd == '/' && !strstr(pwd, "/./") && !strstr(pwd, "/../") &&
+        stat(pwd, &pwd_st) == 0 && stat(".", &dot_st) == 0 &&
+        pwd_st.st_dev == dot_st.st_dev && pwd_st.st_ino == dot_st.st_ino)
+    {
+        size_t len = strlen(pwd);
+        char line[len + 1];
+
+        memcpy(line, pwd, len);
+        line[len] = ASCII_LINE_BREAK;
+        utility_output(line, len + 1);
+        return;
+    }
+
+    char* cwd = getcwd(NULL, 0);
+
+    if (cwd == NULL)
+    {
+        output_error(KRED"\npwd: %s\n\n"KDEF, strerror(errno));
+        last_exit_status = EXIT_FAILURE;
+        return;
+    }
+
+    size_t len = strlen(cwd);
+
+    cwd[len] = ASCII_LINE_BREAK;
+    utility_output(cwd, len + 1);
+    free(cwd);
+}
+
+void execute_printf(char* args)
+{
+    int argc;
+    char** argv = split_arguments(args, &argc);
+
+    if (argc == 0)
+    {
+        output_error(KRED"\nprintf: missing format\n\n"KDEF);
+        last_exit_status = EXIT_FAILURE;
+        free(argv);
+        return;
+    }
+
+    char* buffer = NULL;
+    size_t len = 0;
+    FILE* out = open_memstream(&buffer, &len);
+
+    last_exit_status = printf_format(out, argv[0], argv + 1, argc - 1);
+
+    fclose(out);
+    utility_output(buffer, len);
+    free(buffer);
+    free(argv);
+}
+
+void execute_test(char* args)
+{
+    int argc;
+    char** argv = split_arguments(args, &argc);
+
+    last_exit_status = test_evaluate(argv, argc);
+
+    free(argv);
+}
+
+void execute_bracket(char* args)
+{
+    int argc;
+    char** argv = split_arguments(args, &argc);
+
+    if (argc == 0 || strcmp(argv[argc - 1], "]"))
+    {
+        output_error(KRED"\n[: missing ']'\n\n"KDEF);
+        last_exit_status = TEST_ERROR;
+    }
+    else
+        last_exit_status = test_evaluate(argv, argc - 1);
+
+    free(argv);
+}
+
+void execute_kill(char* args)
+{
+    int argc, i = 0, sig = SIGTERM;
+    char** argv = split_arguments(args, &argc);
+
+    last_exit_status = EXIT_SUCCESS;
+
+    if (argc > 0 && !strcmp(argv[0], "-l"))
+    {
+        char* buffer = NULL;
+        size_t len = 0;
+        FILE* out = open_memstream(&buffer, &len);
+
+        //Con un argumento se traduce un numero de señal, o el estado de salida de un proceso terminado por una señal.
+        if (argc > 1)
+        {
+            int n = atoi(argv[1]);
+            const char* name = sigabbrev_np(n > 128 ? n - 128 : n);
+
+            if (name)
+                fprintf(out, "%s\n", name);
+            else
+            {
+                output_error(KRED"\nkill: %s: invalid signal specification\n\n"KDEF, argv[1]);
+                last_exit_status = EXIT_FAILURE;
+            }
+        }
+        else
+            for (int s = 1; s < NSIG; s++)
+                if (sigabbrev_np(s))
+                    fprintf(out, "%s%c", sigabbrev_np(s), s % 8 ? ' ' : ASCII_LINE_BREAK);
+
+        fclose(out);
+
+        if (len > 0 && buffer[len - 1] != ASCII_LINE_BREAK)
+            buffer[len - 1] = ASCII_LINE_BREAK;
+
+        utility_output(buffer, len);
+        free(buffer);
+        free(argv);
+        return;
+    }
+
+    if (argc > 1 && !strcmp(argv[0], "-s"))
+    {
+        sig = signal_from_name(argv[1]);
+        i = 2;
+    }
+    else if (argc > 0 && !strcmp(argv[0], "--"))
+        i = 1;
+    else if (argc > 0 && argv[0][0] == ASCII_MIDDLE_DASH)
+    {
+        sig = signal_from_name(argv[0] + 1);
+        i = 1;
+    }
+
+    if (i > 0 && i < argc && strcmp(argv[0], "--") && !strcmp(argv[i], "--"))
+        i++;
+
+    if (sig < 0)
+    {
+        output_error(KRED"\nkill: %s: invalid signal specification\n\n"KDEF, argv[i - 1]);
+        last_exit_status = EXIT_FAILURE;
+        free(argv);
+        return;
+    }
+
+    if (i >= argc)
+    {
+        output_error(KRED"\nkill: usage: kill [-s sigspec | -signum | -sigspec] pid | %%job ...\n\n"KDEF);
+        last_exit_status = EXIT_FAILURE;
+    }
+
+    for (; i < argc; i++)
+    {
+        char* end;
+        pid_t pid;
+
+        //"%id" se refiere a un trabajo: la señal se envia a todo su grupo de procesos.
+        if (argv[i][0] == '%')
+        {
+            job* j = get_job_by_id(strtol(argv[i] + 1, &end, 10));
+
+            if (!j || *end || end == argv[i] + 1)
+            {
+                output_error(KRED"\nkill: %s: no such job\n\n"KDEF, argv[i]);
+                last_exit_status = EXIT_FAILURE;
+                continue;
+            }
+
+            //Un trabajo en espera todavia no tiene procesos: se descarta de la cola.
+            if (j->queued)
+            {
+                cancel_queued_job(j);
+                continue;
+            }
+
+            pid = -j->pgid;
+        }
+        else
+        {
+            pid = strtol(argv[i], &end, 10);
+
+            if (*end || end == argv[i])
+            {
+                output_error(KRED"\nkill: %s: arguments must be process or job IDs\n\n"KDEF, argv[i]);
+                last_exit_status = EXIT_FAILURE;
+                continue;
+            }
+        }
+
+        if (kill(pid, sig) < 0)
+        {
+            output_error(KRED"\nkill: (%s) - %s\n\n"KDEF, argv[i], strerror(errno));
+            last_exit_status = EXIT_FAILURE;
+        }
+    }
+
+    free(argv);
+}
+
+void execute_sleep(char* args)
+{
+    int argc;
+    char** argv = split_arguments(args, &argc);
+    double seconds = 0;
+
+    last_exit_status = EXIT_SUCCESS;
+
+    if (argc == 0)
+    {
+        output_error(KRED"\nsleep: missing operand\n\n"KDEF);
+        last_exit_status = EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < argc; i++)
+    {
+        char* end;
+        double value = strtod(argv[i], &end);
+
+        switch (*end)
+        {
+            case 'd': value *= 24; /* fall through */
+            case 'h': value *= 60; /* fall through */
+            case 'm': value *= 60; /* fall through */
+            case 's': end++;       /* fall through */
+            default:  break;
+        }
+
+        if (end == argv[i] || *end || !(value >= 0))
+        {
+            output_error(KRED"\nsleep: invalid time interval '%s'\n\n"KDEF, argv[i]);
+            last_exit_status = EXIT_FAILURE;
+        }
+        else
+            seconds += value;
+    }
+
+    free(argv);
+
+    if (last_exit_status != EXIT_SUCCESS)
+        return;
+
+    struct timespec start, now;
+
+    output_flush();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    //Durante la espera se sigue recogiendo la salida de los trabajos en segundo plano, que de otro modo se bloquearian con el pipe lleno,
+    //y se informan los que terminan, como mientras se espera la entrada.
+    while (1)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        double remaining = seconds - elapsed_seconds(&start, &now);
+
+        if (remaining <= 0)
+            break;
+
+        if (process_job_events(remaining < INT_MAX / 1000 ? remaining * 1000 + 1 : INT_MAX) > 0)
+            output_sync();
+    }
+}
+
+char** split_arguments(char* args, int* argc)
+{
+    int n = 0;
+
+    for (char* c = args; *c; )
+    {
+        while (*c == ASCII_SPACE)
+            c++;
+
+        if (*c)
+            n++;
+
+        while (*c && *c != ASCII_SPACE)
+            c++;
+    }
+
+    char** argv = malloc(sizeof(char*) * (n + 1));
+    char* save;
+
+    *argc = 0;
+
+    for (char* token = strtok_r(args, " ", &save); token; token = strtok_r(NULL, " ", &save))
+        argv[(*argc)++] = token;
+
+    argv[*argc] = NULL;
+
+    return argv;
+}
+
+void utility_output(const char* data, size_t len)
+{
+    if (len == 0)
+        return;
+
+    //Hacia un archivo o un pipe la salida es exactamente la del programa: el color y la linea en blanco solo se agregan en la terminal.
+    if (!isatty(STDOUT_FILENO))
+    {
+        output_append(data, len);
+        return;
+    }
+
+    output_puts(KYEL);
+    output_append(data, len);
+    output_puts(KDEF);
+
+    //Igual que al reenviar la salida de un trabajo, se deja una linea en blanco antes del siguiente prompt.
+    output_puts("\n");
+}
+
+static int test_integer(const char* str, long long* value)
+{
+    char* end;
+
+    errno = 0;
+    *value = strtoll(str, &end, 10);
+
+    if (end == str || *end || errno)
+    {
+        output_error(KRED"\ntest: %s: integer expression expected\n\n"KDEF, str);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_is_unary(const char* op)
+{
+    return op[0] == ASCII_MIDDLE_DASH && op[1] && !op[2] && strchr("bcdefghLnprSstuwxz", op[1]);
+}
+
+static int test_is_binary(const char* op)
+{
+    static const char* ops[] = { "=", "!=", "-eq", "-ne", "-gt", "-ge", "-lt", "-le", "-ef", "-nt", "-ot" };
+
+    for (size_t i = 0; i < CONST_STR_ARR_SIZE(ops); i++)
+        if (!strcmp(op, ops[i]))
+            return 1;
+
+    return 0;
+}
+
+static int test_unary(const char* op, const char* arg)
+{
+    struct stat st;
+
+    switch (op[1])
+    {
+        case 'n': return *arg ? 0 : 1;
+        case 'z': return *arg ? 1 : 0;
+        case 't': return isatty(atoi(arg)) ? 0 : 1;
+        case 'r': return access(arg, R_OK) == 0 ? 0 : 1;
+        case 'w': return access(arg, W_OK) == 0 ? 0 : 1;
+        case 'x': return access(arg, X_OK) == 0 ? 0 : 1;
+        case 'h':
+        case 'L': return lstat(arg, &st) == 0 && S_ISLNK(st.st_mode) ? 0 : 1;
+    }
+
+    if (stat(arg, &st) < 0)
+        return 1;
+
+    switch (op[1])
+    {
+        case 'b': return S_ISBLK(st.st_mode) ? 0 : 1;
+        case 'c': return S_ISCHR(st.st_mode) ? 0 : 1;
+        case 'd': return S_ISDIR(st.st_mode) ? 0 : 1;
+        case 'f': return S_ISREG(st.st_mode) ? 0 : 1;
+        case 'p': return S_ISFIFO(st.st_mode) ? 0 : 1;
+        case 'S': return S_ISSOCK(st.st_mode) ? 0 : 1;
+        case 's': return st.st_size > 0 ? 0 : 1;
+        case 'g': return st.st_mode & S_ISGID ? 0 : 1;
+        case 'u': return st.st_mode & S_ISUID ? 0 : 1;
+        default:  return 0;
+    }
+}
+
+static int test_binary(const char* left, const char* op, const char* right)
+{
+    if (!strcmp(op, "="))
+        return strcmp(left, right) ? 1 : 0;
+    if (!strcmp(op, "!="))
+        return strcmp(left, right) ? 0 : 1;
+
+    if (op[1] == 'e' && op[2] == 'f')
+    {
+        struct stat l, r;
+        return stat(left, &l) == 0 && stat(right, &r) == 0 && l.st_dev == r.st_dev && l.st_ino == r.st_ino ? 0 : 1;
+    }
+
+    if (op[2] == 't' && (op[1] == 'n' || op[1] == 'o'))
+    {
+        struct stat l, r;
+        int l_ok = stat(left, &l) == 0, r_ok = stat(right, &r) == 0;
+
+        if (op[1] == 'o')
+        {
+            struct stat tmp = l; l = r; r = tmp;
+            int tmp_ok = l_ok; l_ok = r_ok; r_ok = tmp_ok;
+        }
+
+        //Un archivo existente es mas nuevo que uno inexistente.
+        if (!l_ok)
+            return 1;
+        if (!r_ok)
+            return 0;
+
+        return l.st_mtim.tv_sec > r.st_mtim.tv_sec ||
+               (l.st_mtim.tv_sec == r.st_mtim.tv_sec && l.st_mtim.tv_nsec > r.st_mtim.tv_nsec) ? 0 : 1;
+    }
+
+    long long l, r;
+
+    if (test_integer(left, &l) < 0 || test_integer(right, &r) < 0)
+        return TEST_ERROR;
+
+    switch (op[1] << 8 | op[2])
+    {
+        case 'e' << 8 | 'q': return l == r ? 0 : 1;
+        case 'n' << 8 | 'e': return l != r ? 0 : 1;
+        case 'g' << 8 | 't': return l > r ? 0 : 1;
+        case 'g' << 8 | 'e': return l >= r ? 0 : 1;
+        case 'l' << 8 | 't': return l < r ? 0 : 1;
+        default:             return l <= r ? 0 : 1;
+    }
+}
+
+static int test_negate(int result)
+{
+    return result == TEST_ERROR ? TEST_ERROR : !result;
+}
+
+static int test_or(char** argv, int argc, int* pos);
+
+static int test_primary(char** argv, int argc, int* pos)
+{
+    if (*pos >= argc)
+        return TEST_ERROR;
+
+    char* arg = argv[(*pos)++];
+
+    if (!strcmp(arg, "!"))
+        return test_negate(test_primary(argv, argc, pos));
+
+    if (!strcmp(arg, "("))
+    {
+        int result = test_or(argv, argc, pos);
+
+        if (*pos >= argc || strcmp(argv[(*pos)++], ")"))
+            return TEST_ERROR;
+
+        return result;
+    }
+
+    if (test_is_unary(arg) && *pos < argc)
+        return test_unary(arg, argv[(*pos)++]);
+
+    if (*pos + 1 < argc && test_is_binary(argv[*pos]))
+    {
+        *pos += 2;
+        return test_binary(arg, argv[*pos - 2], argv[*pos - 1]);
+    }
+
+    return *arg ? 0 : 1;
+}
+
+static int test_and(char** argv, int argc, int* pos)
+{
+    int result = test_primary(argv, argc, pos);
+
+    while (result != TEST_ERROR && *pos < argc && !strcmp(argv[*pos], "-a"))
+    {
+        (*pos)++;
+        int right = test_primary(argv, argc, pos);
+        result = right == TEST_ERROR ? TEST_ERROR : (result || right);
+    }
+
+    return result;
+}
+
+static int test_or(char** argv, int argc, int* pos)
+{
+    int result = test_and(argv, argc, pos);
+
+    while (result != TEST_ERROR && *pos < argc && !strcmp(argv[*pos], "-o"))
+    {
+        (*pos)++;
+        int right = test_and(argv, argc, pos);
+        result = right == TEST_ERROR ? TEST_ERROR : (result && right);
+    }
+
+    return result;
+}
+
+int test_evaluate(char** argv, int argc)
+{
+    int result = TEST_ERROR;
+
+    //Hasta 4 argumentos el resultado lo fija POSIX segun su numero. Con mas se usa la gramatica con !, (), -a y -o.
+    switch (argc)
+    {
+        case 0:
+            return 1;
+
+        case 1:
+            return *argv[0] ? 0 : 1;
+
+        case 2:
+            if (!strcmp(argv[0], "!"))
+                return test_negate(test_evaluate(argv + 1, 1));
+            if (test_is_unary(argv[0]))
+                return test_unary(argv[0], argv[1]);
+            break;
+
+        case 3:
+            if (test_is_binary(argv[1]))
+                return test_binary(argv[0], argv[1], argv[2]);
+            if (!strcmp(argv[1], "-a"))
+                return *argv[0] && *argv[2] ? 0 : 1;
+            if (!strcmp(argv[1], "-o"))
+                return *argv[0] || *argv[2] ? 0 : 1;
+            if (!strcmp(argv[0], "!"))
+                return test_negate(test_evaluate(argv + 1, 2));
+            if (!strcmp(argv[0], "(") && !strcmp(argv[2], ")"))
+                return test_evaluate(argv + 1, 1);
+            break;
+
+        case 4:
+            if (!strcmp(argv[0], "!"))
+                return test_negate(test_evaluate(argv + 1, 3));
+            if (!strcmp(argv[0], "(") && !strcmp(argv[3], ")"))
+                return test_evaluate(argv + 1, 2);
+            /* fall through */
+
+        default:
+        {
+            int pos = 0;
+
+            result = test_or(argv, argc, &pos);
+
+            if (pos != argc)
+                result = TEST_ERROR;
+        }
+    }
+
+    if (result == TEST_ERROR)
+        output_error(KRED"\ntest: invalid expression\n\n"KDEF);
+
+    return result;
+}
+
+static const char* printf_escape(FILE* out, const char* s, int in_argument, int* stop)
+{
+    //s apunta al caracter siguiente a la barra invertida.
+    switch (*s)
+    {
+        case 'a': fputc('\a', out); return s + 1;
+        case 'b': fputc('\b', out); return s + 1;
+        case 'f': fputc('\f', out); return s + 1;
+        case 'n': fputc('\n', out); return s + 1;
+        case 'r': fputc('\r', out); return s + 1;
+        case 't': fputc('\t', out); return s + 1;
+        case 'v': fputc('\v', out); return s + 1;
+        case '\\': fputc('\\', out); return s + 1;
+        case '\0': fputc('\\', out); return s;
+
+        case 'c':
+            if (in_argument)
+            {
+                *stop = 1;
+                return s + 1;
+            }
+            break;
+    }
+
+    //En el formato el octal es \ooo, en los argumentos de %b es \0ooo.
+    if (*s >= '0' && *s <= '7')
+    {
+        int value = 0, digits = 0;
+
+        if (in_argument && *s == '0')
+            s++;
+
+        while (digits < 3 && *s >= '0' && *s <= '7')
+        {
+            value = value * 8 + (*s++ - '0');
+            digits++;
+        }
+
+        fputc(value, out);
+        return s;
+    }
+
+    fputc('\\', out);
+    fputc(*s, out);
+
+    return s + 1;
+}
+
+static long long printf_signed(const char* arg, int* error)
+{
+    //Un argumento que comienza con comillas toma el valor del caracter siguiente.
+    if (*arg == '\'' || *arg == '"')
+        return (unsigned char) arg[1];
+
+    char* end;
+
+    errno = 0;
+
+    long long value = strtoll(arg, &end, 0);
+
+    if (end == arg || *end || errno)
+    {
+        output_error(KRED"\nprintf: %s: invalid number\n\n"KDEF, arg);
+        *error = 1;
+    }
+
+    return value;
+}
+
+static unsigned long long printf_unsigned(const char* arg, int* error)
+{
+    if (*arg == '\'' || *arg == '"')
+        return (unsigned char) arg[1];
+
+    char* end;
+
+    errno = 0;
+
+    unsigned long long value = strtoull(arg, &end, 0);
+
+    if (end == arg || *end || errno)
+    {
+        output_error(KRED"\nprintf: %s: invalid number\n\n"KDEF, arg);
+        *error = 1;
+    }
+
+    return value;
+}
+
+static double printf_double(const char* arg, int* error)
+{
+    if (*arg == '\'' || *arg == '"')
+        return (unsigned char) arg[1];
+
+    char* end;
+    double value = strtod(arg, &end);
+
+    if (end == arg || *end)
+    {
+        output_error(KRED"\nprintf: %s: invalid number\n\n"KDEF, arg);
+        *error = 1;
+    }
+
+    return value;
+}
+
+int printf_format(FILE* out, const char* format, char** argv, int argc)
+{
+    int used = 0, error = 0, stop = 0;
+
+    do
+    {
+        int start = used;
+
+        for (const char* f = format; *f && !stop; )
+        {
+            if (*f == '\\')
+            {
+                f = printf_escape(out, f + 1, 0, &stop);
+                continue;
+            }
+
+            if (*f != '%')
+            {
+                fputc(*f++, out);
+                continue;
+            }
+
+            if (f[1] == '%')
+            {
+                fputc('%', out);
+                f += 2;
+                continue;
+            }
+
+            //Se arma la especificacion de la conversion con los modificadores de C y el tipo ajustado al argumento.
+            char spec[64] = "%";
+            size_t n = 1;
+            int width = 0, precision = -1, has_width = 0;
+
+            for (f++; *f && strchr("-+ #0", *f) && n < 8; f++)
+                spec[n++] = *f;
+
+            if (*f == '*')
+            {
+                width = used < argc ? (int) printf_signed(argv[used++], &error) : 0;
+                has_width = 1;
+                f++;
+            }
+            else
+                for (; isdigit((unsigned char) *f); f++)
+                {
+                    width = width * 10 + (*f - '0');
+                    has_width = 1;
+                }
+
+            if (*f == '.')
+            {
+                precision = 0;
+
+                if (*++f == '*')
+                {
+                    precision = used < argc ? (int) printf_signed(argv[used++], &error) : 0;
+                    f++;
+                }
+                else
+                    for (; isdigit((unsigned char) *f); f++)
+                        precision = precision * 10 + (*f - '0');
+            }
+
+            if (has_width)
+                n += snprintf(spec + n, sizeof(spec) - n, "%d", width);
+            if (precision >= 0)
+                n += snprintf(spec + n, sizeof(spec) - n, ".%d", precision);
+
+            char conversion = *f;
+            const char* arg = used < argc ? argv[used++] : NULL;
+
+            if (conversion)
+                f++;
+
+            switch (conversion)
+            {
+                case 'd':
+                case 'i':
+                    strcpy(spec + n, "lld");
+                    fprintf(out, spec, arg ? printf_signed(arg, &error) : 0LL);
+                    break;
+
+                case 'o':
+                case 'u':
+                case 'x':
+                case 'X':
+                    snprintf(spec + n, sizeof(spec) - n, "ll%c", conversion);
+                    fprintf(out, spec, arg ? printf_unsigned(arg, &error) : 0ULL);
+                    break;
+
+                case 'e':
+                case 'E':
+                case 'f':
+                case 'F':
+                case 'g':
+                case 'G':
+                case 'a':
+                case 'A':
+                    snprintf(spec + n, sizeof(spec) - n, "%c", conversion);
+                    fprintf(out, spec, arg ? printf_double(arg, &error) : 0.0);
+                    break;
+
+                case 'c':
+                    strcpy(spec + n, "c");
+                    if (arg && *arg)
+                        fprintf(out, spec, *arg);
+                    else if (has_width)
+                        fprintf(out, "%*s", spec[1] == ASCII_MIDDLE_DASH ? -width : width, "");
+                    break;
+
+                case 's':
+                    strcpy(spec + n, "s");
+                    fprintf(out, spec, arg ? arg : "");
+                    break;
+
+                case 'b':
+                {
+                    char* expanded = NULL;
+                    size_t len = 0;
+                    FILE* tmp = open_memstream(&expanded, &len);
+
+                    for (const char* s = arg ? arg : ""; *s && !stop; )
+                        if (*s == '\\')
+                            s = printf_escape(tmp, s + 1, 1, &stop);
+                        else
+                            fputc(*s++, tmp);
+
+                    fclose(tmp);
+                    strcpy(spec + n, "s");
+                    fprintf(out, spec, expanded);
+                    free(expanded);
+                    break;
+                }
+
+                default:
+                    output_error(KRED"\nprintf: %%%c: invalid directive\n\n"KDEF, conversion);
+                    return EXIT_FAILURE;
+            }
+        }
+
+        //El formato se reutiliza mientras consuma argumentos y queden argumentos sin usar.
+        if (used == start)
+            break;
+    }
+    while (used < argc && !stop);
+
+    return error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int signal_from_name(const char* name)
+{
+    char* end;
+    long number = strtol(name, &end, 10);
+
+    if (end != name && *end == ASCII_END_OF_STRING)
+        return number >= 0 && number < NSIG ? (int) number : -1;
+
+    if (!strncasecmp(name, "SIG", 3))
+        name += 3;
+
+    for (int s = 1; s < NSIG; s++)
+        if (sigabbrev_np(s) && !strcasecmp(sigabbrev_np(s), name))
+            return s;
+
+    return -1;
+}
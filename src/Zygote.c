@@ -0,0 +1,323 @@
+/**
+ * @file Zygote.c
+ * @author Bottini, Franco Nicolas
+ * @brief Implementacion del zygote de lanzamiento de procesos.
+ * @version 1.2
+ * @date Septiembre de 2022
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "../inc/Zygote.h"
+#include "../inc/JobControl.h"
+
+static int zygote_fd = -1;      /** Extremo del shell del socket. -1 si no hay zygote **/
+static pid_t zygote_owner = -1; /** Proceso que creo el zygote y que recibe sus procesos como hijos **/
+
+static void exec_request(char *path, char **argv, const zygote_request *r, const int fds[ZYGOTE_FDS], char *files[ZYGOTE_FDS])
+{
+    int defaults[] = { SIGINT, SIGQUIT, SIGTSTP, SIGTTIN, SIGTTOU, SIGCHLD };
+    sigset_t mask;
+
+    for (size_t i = 0; i < sizeof(defaults) / sizeof(*defaults); i++)
+        signal(defaults[i], SIG_DFL);
+
+    sigemptyset(&mask);
+    sigprocmask(SIG_SETMASK, &mask, NULL);
+
+    setpgid(0, r->pgid);
+
+    for (int i = 0; i < ZYGOTE_FDS; i++)
+        if (r->redirect_flags[i] < 0)
+            dup2(fds[i], i);
+
+    //Las redirecciones se abren una vez ubicada la salida de errores, donde se informa si alguna falla.
+    for (int i = 0; i < ZYGOTE_FDS; i++)
+    {
+        if (r->redirect_flags[i] < 0)
+            continue;
+
+        int file_fd = open(files[i], r->redirect_flags[i], REDIRECT_FILE_MODE);
+
+        if (file_fd < 0)
+        {
+            fprintf(stderr, "%s: %s\n", files[i], strerror(errno));
+            _exit(EXIT_FAILURE);
+        }
+
+        dup2(file_fd, i);
+        close(file_fd);
+    }
+
+    apply_policy(&r->policy, 0);
+
+    //Si la ruta guardada dejo de ser valida se reintenta con la busqueda normal en PATH.
+    if (path)
+        execv(path, argv);
+
+    execvp(argv[0], argv);
+
+    fprintf(stderr, "Command not found!\n");
+    _exit(EXIT_COMMAND_NOT_FOUND);
+}
+
+//Obtiene el siguiente string del pedido, solo si termina en '\0' dentro del mensaje.
+static char* next_string(char **str, const char *end)
+{
+    char *s = *str;
+    char *nul = s < end ? memchr(s, '\0', end - s) : NULL;
+
+    if (nul == NULL)
+        return NULL;
+
+    *str = nul + 1;
+
+    return s;
+}
+
+static pid_t serve_request(char *data, size_t len, const int fds[ZYGOTE_FDS])
+{
+    zygote_request *r = (zygote_request*) data;
+    char *str = data + sizeof(zygote_request);
+    char *end = data + len;
+    char *path = NULL;
+    char *files[ZYGOTE_FDS] = { NULL };
+
+    //Cada argumento ocupa al menos un byte, lo que acota argc antes de reservar memoria.
+    if (r->argc == 0 || r->argc > (size_t) (end - str))
+        return -1;
+
+    if (r->has_path && (path = next_string(&str, end)) == NULL)
+        return -1;
+
+    char **argv = malloc(sizeof(char*) * (r->argc + 1));
+
+    for (uint32_t i = 0; i < r->argc; i++)
+    {
+        if ((argv[i] = next_string(&str, end)) == NULL)
+        {
+            free(argv);
+            return -1;
+        }
+    }
+
+    argv[r->argc] = NULL;
+
+    for (int i = 0; i < ZYGOTE_FDS; i++)
+    {
+        if (r->redirect_flags[i] < 0)
+            continue;
+
+        if ((files[i] = next_string(&str, end)) == NULL)
+        {
+            free(argv);
+            return -1;
+        }
+    }
+
+    //CLONE_PARENT entrega el proceso como hijo del shell: el zygote no lo espera ni recibe su SIGCHLD.
+    pid_t pid = syscall(SYS_clone, CLONE_PARENT | SIGCHLD, 0, NULL, NULL, 0);
+
+    if (pid == 0)
+        exec_request(path, argv, r, fds, files);
+
+    free(argv);
+
+    return pid;
+}
+
+static void zygote_loop(int sock)
+{
+    static char buffer[ZYGOTE_REQUEST_SIZE];
+    union
+    {
+        char data[CMSG_SPACE(sizeof(int) * ZYGOTE_FDS)];
+        struct cmsghdr align;
+    } control;
+
+    while (1)
+    {
+        struct iovec iov = { .iov_base = buffer, .iov_len = sizeof(buffer) };
+        struct msghdr msg = {
+            .msg_iov = &iov,
+            .msg_iovlen = 1,
+            .msg_control = control.data,
+            .msg_controllen = sizeof(control.data)
+        };
+
+        //Los descriptores recibidos son close-on-exec: solo los procesos lanzados los heredan, a traves de dup2.
+        ssize_t n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        //El shell cerro su extremo del socket.
+        if (n <= 0)
+            _exit(EXIT_SUCCESS);
+
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        zygote_request *r = (zygote_request*) buffer;
+        int received[ZYGOTE_FDS], fds[ZYGOTE_FDS];
+        int nfds = 0, expected = 0;
+        pid_t pid = -1;
+
+        if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+        {
+            nfds = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            nfds = nfds < ZYGOTE_FDS ? nfds : ZYGOTE_FDS;
+            memcpy(received, CMSG_DATA(cmsg), sizeof(int) * nfds);
+        }
+
+        //Los descriptores recibidos corresponden, en orden, a los flujos que no se redirigen.
+        if ((size_t) n >= sizeof(zygote_request))
+            for (int i = 0; i < ZYGOTE_FDS; i++)
+            {
+                fds[i] = -1;
+
+                if (r->redirect_flags[i] >= 0)
+                    continue;
+
+                if (expected < nfds)
+                    fds[i] = received[expected];
+
+                expected++;
+            }
+
+        if ((size_t) n >= sizeof(zygote_request) && nfds == expected && !(msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)))
+            pid = serve_request(buffer, n, fds);
+
+        for (int i = 0; i < nfds; i++)
+            close(received[i]);
+
+        send(sock, &pid, sizeof(pid), MSG_NOSIGNAL);
+    }
+}
+
+int zygote_start(void)
+{
+    int sv[2];
+
+    zygote_stop();
+
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) < 0)
+        return -1;
+
+    pid_t pid = fork();
+
+    if (pid < 0)
+    {
+        close(sv[0]);
+        close(sv[1]);
+        return -1;
+    }
+
+    if (pid == 0)
+    {
+        //El zygote no debe mantener abiertos los pipes ni la terminal del shell: solo conserva su extremo del socket.
+        int null_fd = open("/dev/null", O_RDWR);
+
+        for (int i = 0; i < ZYGOTE_FDS; i++)
+            dup2(null_fd, i);
+
+        close_range(ZYGOTE_FDS, sv[1] - 1, 0);
+        close_range(sv[1] + 1, ~0U, 0);
+
+        zygote_loop(sv[1]);
+    }
+
+    close(sv[1]);
+
+    zygote_fd = sv[0];
+    zygote_owner = getpid();
+
+    return 0;
+}
+
+void zygote_stop(void)
+{
+    if (zygote_fd >= 0)
+        close(zygote_fd);
+
+    zygote_fd = -1;
+    zygote_owner = -1;
+}
+
+pid_t zygote_launch(const char *path, char **argv, int argc, pid_t pgid, const int fds[ZYGOTE_FDS],
+                    const char *const redirect[ZYGOTE_FDS], const int redirect_flags[ZYGOTE_FDS], const job_policy *policy)
+{
+    if ((zygote_fd < 0 || zygote_owner != getpid()) && zygote_start() < 0)
+        return ZYGOTE_UNAVAILABLE;
+
+    static char buffer[ZYGOTE_REQUEST_SIZE];
+    zygote_request *r = (zygote_request*) buffer;
+    size_t len = sizeof(zygote_request);
+
+    int sent[ZYGOTE_FDS], nfds = 0;
+
+    r->pgid = pgid > 0 ? pgid : 0;
+    r->argc = argc;
+    r->has_path = path != NULL;
+    r->policy = *policy;
+
+    for (int i = 0; i < ZYGOTE_FDS; i++)
+    {
+        r->redirect_flags[i] = redirect[i] ? redirect_flags[i] : -1;
+
+        if (!redirect[i])
+            sent[nfds++] = fds[i];
+    }
+
+    //Se empaquetan la ruta, los argumentos y los archivos redirigidos, en ese orden.
+    for (int i = -1; i < argc + ZYGOTE_FDS; i++)
+    {
+        const char *str = i < 0 ? path : i < argc ? argv[i] : redirect[i - argc];
+
+        if (str == NULL)
+            continue;
+
+        size_t n = strlen(str) + 1;
+
+        if (len + n > sizeof(buffer))
+            return ZYGOTE_UNAVAILABLE;
+
+        memcpy(buffer + len, str, n);
+        len += n;
+    }
+
+    union
+    {
+        char data[CMSG_SPACE(sizeof(int) * ZYGOTE_FDS)];
+        struct cmsghdr align;
+    } control;
+
+    struct iovec iov = { .iov_base = buffer, .iov_len = len };
+    struct msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = nfds ? control.data : NULL,
+        .msg_controllen = nfds ? CMSG_SPACE(sizeof(int) * nfds) : 0
+    };
+
+    if (nfds)
+    {
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * nfds);
+        memcpy(CMSG_DATA(cmsg), sent, sizeof(int) * nfds);
+    }
+
+    pid_t pid;
+
+    //Si el zygote termino se descarta: el pedido se atiende con otro mecanismo y el proximo crea uno nuevo.
+    if (sendmsg(zygote_fd, &msg, MSG_NOSIGNAL) != (ssize_t) len ||
+        TEMP_FAILURE_RETRY(recv(zygote_fd, &pid, sizeof(pid), 0)) != sizeof(pid))
+    {
+        zygote_stop();
+        return ZYGOTE_UNAVAILABLE;
+    }
+
+    return pid;
+}
@@ -0,0 +1,241 @@
+#!/bin/sh
+#
+# @file Regression.sh
+# @author Bottini, Franco Nicolas
+# @brief Pruebas de regresion de MyShell. Cada caso envia una linea de comandos por la entrada estandar (un pipe, por lo que
+# el shell corre en modo no interactivo) y busca en la salida, sin codigos de color ni espacios finales, la linea esperada.
+#
+# Uso: Regression.sh <ruta de MyShell>
+# @version 1.2
+# @date Septiembre de 2022
+#
+
+SHELL_BIN=${1:-bin/MyShell}
+FAILED=0
+TOTAL=0
+OUTPUT_FILE=$(mktemp)
+REDIRECT_FILE=$(mktemp)
+
+trap 'rm -f "$OUTPUT_FILE" "$REDIRECT_FILE"' EXIT
+
+# check <nombre> <entrada> <linea esperada en la salida> [tiempo maximo en milisegundos]
+check()
+{
+    TOTAL=$((TOTAL + 1))
+    START=$(date +%s%N)
+    printf '%s\n' "$2" | timeout 10 "$SHELL_BIN" > "$OUTPUT_FILE" 2>&1
+    STATUS=$?
+    ELAPSED=$((($(date +%s%N) - START) / 1000000))
+    OUTPUT=$(sed 's/\x1b\[[0-9;]*m//g; s/[[:space:]]*$//' "$OUTPUT_FILE")
+
+    if [ $STATUS -ne 0 ] || ! printf '%s' "$OUTPUT" | grep -qxF -- "$3" || [ "${4:-$ELAPSED}" -lt $ELAPSED ]
+    then
+        FAILED=$((FAILED + 1))
+        printf 'FAIL %s (exit %d, %d ms)\n  expected: %s\n  got:\n%s\n' "$1" $STATUS $ELAPSED "$3" "$OUTPUT"
+    fi
+}
+
+# check_redirect <nombre> <entrada> <contenido esperado del archivo redirigido, en formato de printf>
+check_redirect()
+{
+    TOTAL=$((TOTAL + 1))
+    : > "$REDIRECT_FILE"
+    printf '%s\n' "$2" | timeout 10 "$SHELL_BIN" > "$OUTPUT_FILE" 2>&1
+    STATUS=$?
+
+    if [ $STATUS -ne 0 ] || ! printf "$3" | cmp -s - "$REDIRECT_FILE"
+    then
+        FAILED=$((FAILED + 1))
+        printf 'FAIL %s (exit %d)\n  expected: %s\n  got:\n' "$1" $STATUS "$3"
+        od -c "$REDIRECT_FILE"
+    fi
+}
+
+# check_min_time <nombre> <tiempo minimo en milisegundos>: el caso anterior debe haber tardado al menos ese tiempo.
+check_min_time()
+{
+    TOTAL=$((TOTAL + 1))
+
+    if [ $ELAPSED -lt $2 ]
+    then
+        FAILED=$((FAILED + 1))
+        printf 'FAIL %s\n  expected at least %d ms, took %d ms\n' "$1" $2 $ELAPSED
+    fi
+}
+
+# check_batch <nombre> <batchfile> <linea esperada en la salida>
+check_batch()
+{
+    TOTAL=$((TOTAL + 1))
+    timeout 10 "$SHELL_BIN" "$2" > "$OUTPUT_FILE" 2>&1
+    STATUS=$?
+    OUTPUT=$(sed 's/\x1b\[[0-9;]*m//g; s/[[:space:]]*$//' "$OUTPUT_FILE")
+
+    if [ $STATUS -ne 0 ] || ! printf '%s' "$OUTPUT" | grep -qxF -- "$3"
+    then
+        FAILED=$((FAILED + 1))
+        printf 'FAIL %s (exit %d)\n  expected: %s\n  got:\n%s\n' "$1" $STATUS "$3" "$OUTPUT"
+    fi
+}
+
+# check_true <nombre> <comando>: el comando debe terminar con exito.
+check_true()
+{
+    TOTAL=$((TOTAL + 1))
+
+    if ! eval "$2"
+    then
+        FAILED=$((FAILED + 1))
+        printf 'FAIL %s\n  condition: %s\n' "$1" "$2"
+    fi
+}
+
+check "lone ampersand" '&' 'Invalid pipeline !'
+check "ampersand as last stage" 'ls | &' 'Invalid pipeline !'
+check "builtin piped into ampersand" 'echo a | &' 'Invalid pipeline !'
+
+for backend in fork spawn zygote
+do
+    export MYSHELL_LAUNCH=$backend
+
+    check "command not found status ($backend)" "nosuchcmd
+echo \$?" '127'
+    check "failed redirection status ($backend)" "cat < /nonexistent
+echo \$?" '1'
+done
+
+unset MYSHELL_LAUNCH
+
+# Un hijo que el trabajo deja en segundo plano conserva el pipe de salida: el shell no debe esperar a que lo cierre.
+printf 'sleep 3 & echo started\n' > "$REDIRECT_FILE"
+# Un trabajo en primer plano que se suspende y luego se reanuda pasa a segundo plano: su salida se muestra y se elimina al terminar.
+SCRIPT_FILE=$(mktemp)
+printf 'kill -STOP $$; echo resumed\n' > "$SCRIPT_FILE"
+check "suspended foreground job resumed" "sh $SCRIPT_FILE
+kill -CONT %1
+sleep 0.5" 'resumed'
+check "resumed job removed when done" "sh $SCRIPT_FILE
+kill -CONT %1
+sleep 0.5
+output 1" 'output: 1: no such job'
+rm -f "$SCRIPT_FILE"
+
+check "job leaving a child holding stdout" "sh $REDIRECT_FILE
+echo next" 'next' 1500
+
+check_redirect "echo redirected" "echo redirected > $REDIRECT_FILE" 'redirected\n'
+check_redirect "echo appended" "echo one > $REDIRECT_FILE
+echo two  words >>$REDIRECT_FILE" 'one\ntwo words\n'
+check_redirect "printf redirected" "printf abc > $REDIRECT_FILE" 'abc'
+check_redirect "pwd redirected" "pwd > $REDIRECT_FILE" "$PWD\\n"
+check "builtin failed redirection status" "echo x > /nonexistent/file
+echo \$?" '1'
+
+# Forma compilada de los batchfiles (.<nombre>.msc junto al batchfile).
+SCRIPT_DIR=$(mktemp -d)
+SCRIPT=$SCRIPT_DIR/cached.sh
+CACHE=$SCRIPT_DIR/.cached.sh.msc
+
+printf 'echo first version\n' > "$SCRIPT"
+check_batch "batch compiled" "$SCRIPT" 'first version'
+check_true "compiled form saved" '[ -s "$CACHE" ]'
+CACHE_INODE=$(stat -c %i "$CACHE")
+check_batch "batch from compiled form" "$SCRIPT" 'first version'
+check_true "compiled form reused" '[ "$(stat -c %i "$CACHE")" = "$CACHE_INODE" ]'
+
+printf 'echo second version, longer\n' > "$SCRIPT"
+check_batch "modified batch recompiled" "$SCRIPT" 'second version, longer'
+check_true "compiled form replaced" '[ "$(stat -c %i "$CACHE")" != "$CACHE_INODE" ]'
+
+CACHE_SIZE=$(stat -c %s "$CACHE")
+truncate -s 20 "$CACHE"
+check_batch "truncated compiled form" "$SCRIPT" 'second version, longer'
+check_true "truncated compiled form rewritten" '[ "$(stat -c %s "$CACHE")" = "$CACHE_SIZE" ]'
+
+# Se daña el final de la cabecera y el comienzo de la primera linea compilada (su longitud).
+printf 'XXXXXXXXXXXXXXXX' | dd of="$CACHE" bs=1 seek=56 conv=notrunc 2> /dev/null
+check_batch "corrupted compiled form" "$SCRIPT" 'second version, longer'
+
+rm -rf "$SCRIPT_DIR"
+
+# Cola de trabajos en segundo plano (bgmax): los que exceden el limite esperan y se lanzan en orden de llegada.
+check "bgmax queues extra jobs" 'bgmax 1
+sleep 0.3 &
+sleep 0.3 &
+sleep 0.3 &
+jobs' '[3] queued sleep'
+check_true "jobs lists the queued jobs" '[ "$(grep -c "queued sleep" "$OUTPUT_FILE")" = 4 ]'
+check "bgmax starts queued jobs as slots free up" 'bgmax 1
+sleep 0.3 &
+/bin/echo first &
+/bin/echo second &
+/bin/echo third &
+sleep 0.5
+jobs' 'third' 5000
+check_true "queued jobs run in FIFO order" '[ "$(sed "s/\x1b\[[0-9;]*m//g" "$OUTPUT_FILE" | grep -x -e first -e second -e third | tr "\n" " ")" = "first second third " ]'
+
+# Buffer de salida de los trabajos en segundo plano y comando output.
+SCRIPT_FILE=$(mktemp)
+printf 'seq 1 5; sleep 1\n' > "$SCRIPT_FILE"
+check "output of a background job" "sh $SCRIPT_FILE &
+sleep 0.3
+output 1" '5'
+check_true "output shows the whole buffer" '[ "$(sed "s/\x1b\[[0-9;]*m//g" "$OUTPUT_FILE" | grep -x "[0-9]" | tr "\n" " ")" = "1 2 3 4 5 " ]'
+check "output -n shows the last lines" "sh $SCRIPT_FILE &
+sleep 0.3
+output -n 2 1" '4'
+check_true "output -n skips older lines" '! sed "s/\x1b\[[0-9;]*m//g" "$OUTPUT_FILE" | grep -qx 3'
+check "output of an unknown job" 'output 9' 'output: 9: no such job'
+
+# seq 1 20000 escribe 108894 bytes: el buffer de 64 KB conserva los mas nuevos, desde la primera linea completa (8894).
+printf 'seq 1 20000; sleep 1\n' > "$SCRIPT_FILE"
+check "output after the ring overflows" "sh $SCRIPT_FILE &
+sleep 0.3
+output 1" '20000'
+check_true "overflowed ring keeps the newest lines" '[ "$(sed "s/\x1b\[[0-9;]*m//g" "$OUTPUT_FILE" | grep -x "[0-9][0-9]*" | head -1)" = 8894 ]'
+rm -f "$SCRIPT_FILE"
+
+# Utilidades ejecutadas dentro del shell.
+check "printf conversions" 'printf %s-%d,%5.2f,%x,%o,%c\n abc 42 3.14159 255 8 xyz' 'abc-42, 3.14,ff,10,x'
+check "printf escapes" 'printf [a\tb\\c\101]\n' '[a	b\cA]'
+check "printf reuses the format" 'printf (%s)\n x y' '(y)'
+check "printf %b" 'printf %b\n A\101' 'AA'
+check "test string equal" 'test abc = abc
+echo $?' '0'
+check "test string not equal" 'test abc != abc
+echo $?' '1'
+check "test -n" 'test -n abc
+echo $?' '0'
+check "test integer -lt" 'test 3 -lt 10
+echo $?' '0'
+check "test integer -le" 'test 10 -le 3
+echo $?' '1'
+check "test integer expected" 'test abc -gt 1
+echo $?' '2'
+check "test -f" 'test -f /etc/passwd
+echo $?' '0'
+check "test -d on a file" 'test -d /etc/passwd
+echo $?' '1'
+check "test !" 'test ! -e /nonexistent
+echo $?' '0'
+check "test without arguments" 'test
+echo $?' '1'
+check "bracket" '[ 5 -eq 5 ]
+echo $?' '0'
+check "bracket missing ]" '[ 5 -eq 5
+echo $?' '2'
+check "kill %id" 'sleep 100 &
+kill %1
+sleep 0.3
+output 1' 'output: 1: no such job'
+check "kill unknown job" 'kill %9
+echo $?' '1'
+check "sleep suffixes" 'sleep 0.2s 0.005m
+echo $?' '0' 3000
+check_min_time "sleep suffixes add up" 500
+check "sleep invalid suffix" 'sleep 1x
+echo $?' '1'
+
+printf '%d/%d passed\n' $((TOTAL - FAILED)) $TOTAL
+
+[ $FAILED -eq 0 ]
@@ -0,0 +1,79 @@
+/**
+ * @file BuiltinsGen.c
+ * @author Bottini, Franco Nicolas
+ * @brief Generador de la tabla de hash perfecto de los comandos internos. Se ejecuta al compilar y escribe por stdout
+ * un header con la semilla y la tabla de posiciones, de forma que cada nombre de Builtins.def cae en una posicion propia.
+ * @version 1.2
+ * @date Septiembre de 2022
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../inc/Builtins.h"
+
+/** Intentos de semilla para cada tamaño de tabla antes de duplicarlo **/
+#define SEEDS_PER_SIZE 100000
+
+static const char* names[] = {
+#define BUILTIN(id, name, handler, kind) name,
+#include "../inc/Builtins.def"
+#undef BUILTIN
+};
+
+static int try_seed(uint32_t seed, size_t size, signed char* slots)
+{
+    memset(slots, -1, size);
+
+    for (size_t i = 0; i < CMM_BUILTINS_COUNT; i++)
+    {
+        size_t slot = builtin_hash(names[i], strlen(names[i]), seed) & (size - 1);
+
+        if (slots[slot] >= 0)
+            return 0;
+
+        slots[slot] = i;
+    }
+
+    return 1;
+}
+
+int main(void)
+{
+    size_t size = 1;
+
+    //La tabla es una potencia de dos de al menos el doble de comandos, asi la posicion se obtiene con una mascara.
+    while (size < 2 * CMM_BUILTINS_COUNT)
+        size <<= 1;
+
+    for (;; size <<= 1)
+    {
+        signed char slots[size];
+
+        for (uint32_t seed = 0; seed < SEEDS_PER_SIZE; seed++)
+        {
+            if (!try_seed(seed, size, slots))
+                continue;
+
+            printf("/* Generado por tools/BuiltinsGen.c a partir de inc/Builtins.def. No editar. */\n\n");
+            printf("#ifndef __BUILTINS_TABLE_H__\n#define __BUILTINS_TABLE_H__\n\n");
+            printf("/** Semilla del hash de los nombres de comandos internos **/\n");
+            printf("#define BUILTIN_HASH_SEED %uu\n\n", seed);
+            printf("/** Mascara para obtener la posicion en la tabla a partir del hash **/\n");
+            printf("#define BUILTIN_HASH_MASK %zuu\n\n", size - 1);
+            printf("/** Comando interno de cada posicion de la tabla. -1 si la posicion esta libre **/\n");
+            printf("static const signed char BUILTIN_SLOTS[%zu] = {", size);
+
+            for (size_t i = 0; i < size; i++)
+                printf("%s%d", i ? ", " : " ", slots[i]);
+
+            printf(" };\n\n#endif //__BUILTINS_TABLE_H__\n");
+
+            return EXIT_SUCCESS;
+        }
+    }
+}